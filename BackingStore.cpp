@@ -1,4 +1,5 @@
 #include "BackingStore.h"
+#include "LogWriter.h"
 #include <iostream>
 #include <fstream>
 #include <chrono>
@@ -26,26 +27,21 @@ void BackingStore::removeProcess(int pid) {
 	}
 }
 
+// Records the swap-out for memory/backing-store.log; the log writer thread does the file work
 void BackingStore::storeProcess(int pid) {
-    std::ofstream outFile;
-
-    outFile.open("backing-store.txt", std::ios::app); //append
-
-    if (outFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        time_t currentTime = std::chrono::system_clock::to_time_t(now);
-        struct tm buf;
-        localtime_s(&buf, &currentTime);
-        char timeStr[100];
-        strftime(timeStr, sizeof(timeStr), "%m/%d/%Y %I:%M:%S %p", &buf);
-
-        outFile << processStore[pid]->getName() << "  |  " << pid << "  |  "
-            << processStore[pid]->getCommandCounter() << "/"
-            << processStore[pid]->getLinesOfCode() << " ("
-            << timeStr << ")\n";
-
-        outFile.close();
+    auto found = processStore.find(pid);
+    if (found == processStore.end()) {
+        return;
     }
+    LogWriter::getInstance()->log({ static_cast<int64_t>(std::time(nullptr)), pid, -1, LogRecord::SWAP_OUT, Opcode::PRINT,
+        static_cast<uint32_t>(found->second->getCommandCounter()), static_cast<uint32_t>(found->second->getLinesOfCode()) });
+    LogWriter::getInstance()->publish();
+}
+
+// Records a single page written out by the page replacement; published with the slice's records
+void BackingStore::storePage(int pid, int page, int pages) {
+    LogWriter::getInstance()->log({ static_cast<int64_t>(std::time(nullptr)), pid, -1, LogRecord::PAGE_OUT, Opcode::PRINT,
+        static_cast<uint32_t>(page), static_cast<uint32_t>(pages) });
 }
 
 
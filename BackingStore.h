@@ -13,6 +13,7 @@ public:
     std::shared_ptr<Process> getProcess(int pid);
 	void removeProcess(int pid);
     void storeProcess(int pid);
+    void storePage(int pid, int page, int pages);
 
 private:
     std::unordered_map<int, std::shared_ptr<Process>> processStore;
@@ -5,20 +5,14 @@
 #include <iomanip>
 #include <ctime>
 #include <string>
-#include <sstream>
 using String = std::string;
 
 BaseScreen::BaseScreen(const std::string& processName, std::shared_ptr<Process> process) :
-            AConsole(processName), thisProcess(process) {
-    time_t now = time(nullptr);
-    tm localTime;
-    localtime_s(&localTime, &now);
+            AConsole(processName), timeCreated(time(nullptr)), thisProcess(process) {}
 
-    std::ostringstream timeString;
-    timeString << std::put_time(&localTime, "%m/%d/%Y, %I:%M:%S %p"); 
-                                        //(MM/DD/YYYY, HH:MM:SS AM/PM) format
-    timeCreated = timeString.str();
-}
+// For screens made in a batch, which share one creation time
+BaseScreen::BaseScreen(const std::string& processName, std::shared_ptr<Process> process, time_t timeCreated) :
+            AConsole(processName), timeCreated(timeCreated), thisProcess(process) {}
 
 void BaseScreen::onEnabled() {
     refreshed = false;
@@ -56,7 +50,10 @@ void BaseScreen::printProcessInfo() {
     std::cout << "\033[97m";
     std::cout << "Process Name: " << name << std::endl;
     std::cout << "ID: " << thisProcess->getPID() << std::endl;
-    std::cout << "Created: " << timeCreated << std::endl;
+    tm localTime;
+    localtime_s(&localTime, &timeCreated);
+    std::cout << "Created: " << std::put_time(&localTime, "%m/%d/%Y, %I:%M:%S %p") << std::endl;
+                                        //(MM/DD/YYYY, HH:MM:SS AM/PM) format
     std::cout << "Current Line of Instruction: "
         << thisProcess->getCommandCounter() << " / " << thisProcess->getLinesOfCode() << std::endl;
     if (isDone())
@@ -76,6 +73,8 @@ void BaseScreen::updates() {
         std::cout << "Current Line of Instruction: " << thisProcess->getCommandCounter() << std::endl;
         std::cout << "Lines of code: " << thisProcess->getLinesOfCode() << std::endl;
     }
+    std::cout << std::endl << "Logs:" << std::endl;
+    thisProcess->printLogs(std::cout);
     std::cout << std::endl;
 }
 
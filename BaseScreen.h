@@ -3,10 +3,12 @@
 #include "Process.h"
 #include <memory>
 #include <string>
+#include <ctime>
 
 class BaseScreen : public AConsole {
 public:
     BaseScreen(const std::string& processName, std::shared_ptr<Process> process);
+    BaseScreen(const std::string& processName, std::shared_ptr<Process> process, time_t timeCreated);
     void onEnabled() override;
     void display() override;
     void process() override;
@@ -17,7 +19,7 @@ public:
 private:
     void printProcessInfo();
     bool refreshed = false;
-    std::string timeCreated;
+    time_t timeCreated;     // formatted only when the screen is shown
     std::shared_ptr<Process> thisProcess;
 };
 
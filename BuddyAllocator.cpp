@@ -0,0 +1,138 @@
+#include "BuddyAllocator.h"
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit, bits must not be 0
+static int lowestSetBit(uint32_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+// The range is covered by the largest aligned blocks that fit, so a size that is not a power of
+// two still is managed whole; blocks whose buddy lies past the end never merge.
+BuddyAllocator::BuddyAllocator(int totalSize, int minBlock) : minBlock(std::max(minBlock, 1)) {
+    leaves = totalSize / this->minBlock;
+    maxOrder = 0;
+    while ((2 << maxOrder) <= leaves) {
+        maxOrder++;
+    }
+    heads.assign(maxOrder + 1, -1);
+    next.assign(leaves, -1);
+    prev.assign(leaves, -1);
+    freeOrder.assign(leaves, -1);
+    usedOrder.assign(leaves, -1);
+
+    int leaf = 0;
+    for (int order = maxOrder; order >= 0; order--) {
+        if (leaf + (1 << order) <= leaves) {
+            push(leaf, order);
+            freeSize += (1 << order) * this->minBlock;
+            leaf += 1 << order;
+        }
+    }
+}
+
+// Smallest order whose block holds size
+int BuddyAllocator::orderFor(int size) const {
+    int order = 0;
+    while (order <= maxOrder && (1 << order) * minBlock < size) {
+        order++;
+    }
+    return order;
+}
+
+int BuddyAllocator::blockSize(int size) const {
+    return (1 << orderFor(size)) * minBlock;
+}
+
+// Takes the smallest free block that is big enough and splits it down, the upper halves going
+// to the free lists of the orders below
+int BuddyAllocator::allocate(int size) {
+    int order = orderFor(size);
+    if (order > maxOrder) {
+        return -1;
+    }
+    uint32_t candidates = nonEmpty & ~((1u << order) - 1);
+    if (candidates == 0) {
+        return -1;
+    }
+    int found = lowestSetBit(candidates);
+    int leaf = heads[found];
+    remove(leaf, found);
+    while (found > order) {
+        found--;
+        push(leaf + (1 << found), found);
+    }
+    usedOrder[leaf] = static_cast<int8_t>(order);
+    freeSize -= (1 << order) * minBlock;
+    return leaf * minBlock;
+}
+
+// Gives a block back, merging it with its buddy for as long as the buddy is free as a whole
+void BuddyAllocator::deallocate(int address) {
+    int leaf = address / minBlock;
+    int order = usedOrder[leaf];
+    if (order < 0) {
+        return;
+    }
+    usedOrder[leaf] = -1;
+    freeSize += (1 << order) * minBlock;
+    while (order < maxOrder) {
+        int buddy = leaf ^ (1 << order);
+        if (buddy + (1 << order) > leaves || freeOrder[buddy] != order) {
+            break;
+        }
+        remove(buddy, order);
+        leaf = std::min(leaf, buddy);
+        order++;
+    }
+    push(leaf, order);
+}
+
+int BuddyAllocator::getFreeSize() const {
+    return freeSize;
+}
+
+int BuddyAllocator::largestFreeBlock() const {
+    if (nonEmpty == 0) {
+        return 0;
+    }
+    int order = 31;
+    while (!(nonEmpty & (1u << order))) {
+        order--;
+    }
+    return (1 << order) * minBlock;
+}
+
+int BuddyAllocator::getMinBlock() const {
+    return minBlock;
+}
+
+void BuddyAllocator::push(int leaf, int order) {
+    freeOrder[leaf] = static_cast<int8_t>(order);
+    prev[leaf] = -1;
+    next[leaf] = heads[order];
+    if (heads[order] >= 0) {
+        prev[heads[order]] = leaf;
+    }
+    heads[order] = leaf;
+    nonEmpty |= 1u << order;
+}
+
+void BuddyAllocator::remove(int leaf, int order) {
+    freeOrder[leaf] = -1;
+    (prev[leaf] >= 0 ? next[prev[leaf]] : heads[order]) = next[leaf];
+    if (next[leaf] >= 0) {
+        prev[next[leaf]] = prev[leaf];
+    }
+    if (heads[order] < 0) {
+        nonEmpty &= ~(1u << order);
+    }
+}
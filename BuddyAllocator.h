@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Buddy allocator over a range of memory [0, totalSize). Blocks are a power of two times the
+// smallest block; each order has its own free list, and a freed block merges with its buddy
+// while the buddy is free, so allocate and deallocate take O(log n).
+class BuddyAllocator {
+public:
+    BuddyAllocator(int totalSize, int minBlock);
+
+    int allocate(int size);             // address of the block, -1 if no free block is big enough
+    void deallocate(int address);
+    int blockSize(int size) const;      // size of the block a request of size gets
+
+    int getFreeSize() const;
+    int largestFreeBlock() const;
+    int getMinBlock() const;
+
+private:
+    int orderFor(int size) const;
+    void push(int leaf, int order);
+    void remove(int leaf, int order);
+
+    int minBlock;
+    int leaves;                     // blocks of the smallest size in the managed range
+    int maxOrder;
+    int freeSize = 0;
+    uint32_t nonEmpty = 0;          // bit per order, set while the order's free list has a block
+    std::vector<int> heads;         // free list of each order, by first leaf of the block
+    std::vector<int> next;          // free list links, by first leaf
+    std::vector<int> prev;
+    std::vector<int8_t> freeOrder;  // order of the free block starting at a leaf, -1 if none starts there
+    std::vector<int8_t> usedOrder;  // order of the allocated block starting at a leaf, -1 if none
+};
@@ -0,0 +1,39 @@
+#include "ClockReplacement.h"
+
+ClockReplacement::ClockReplacement(int frames) : loaded(frames, 0), referenced(frames, 0) {}
+
+void ClockReplacement::onLoad(int frame) {
+    loaded[frame] = 1;
+    referenced[frame] = 1;
+}
+
+void ClockReplacement::onTouch(int frame) {
+    referenced[frame] = 1;
+}
+
+void ClockReplacement::onFree(int frame) {
+    loaded[frame] = 0;
+    referenced[frame] = 0;
+}
+
+// Clears reference bits as it goes, so it stops within two turns of the hand
+int ClockReplacement::victim() {
+    int frames = static_cast<int>(loaded.size());
+    while (true) {
+        int frame = hand;
+        hand = (hand + 1) % frames;
+        if (!loaded[frame]) {
+            continue;
+        }
+        if (referenced[frame]) {
+            referenced[frame] = 0;  //second chance
+            continue;
+        }
+        loaded[frame] = 0;
+        return frame;
+    }
+}
+
+std::string ClockReplacement::getName() const {
+    return "clock";
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <cstdint>
+
+// Second chance: a hand sweeps the frames and replaces the first one not referenced since the
+// hand last passed it. A reference only sets a bit, so it is cheaper than LRU's list move.
+class ClockReplacement : public ReplacementPolicy {
+public:
+    explicit ClockReplacement(int frames);
+    void onLoad(int frame) override;
+    void onTouch(int frame) override;
+    void onFree(int frame) override;
+    int victim() override;
+    std::string getName() const override;
+
+private:
+    std::vector<uint8_t> loaded;
+    std::vector<uint8_t> referenced;
+    int hand = 0;
+};
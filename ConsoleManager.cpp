@@ -2,6 +2,7 @@
 #include "BaseScreen.h"
 #include "MainConsole.h"
 #include "Process.h"
+#include "SlabPool.h"
 #include <iostream>
 
 // Initialize the static singleton instance to nullptr
@@ -58,6 +59,7 @@ void ConsoleManager::process() const {
 
 // Switch to another console by name
 void ConsoleManager::switchConsole(const std::string& name) {
+    std::unique_lock<std::mutex> lock(tableMutex);
     auto processScreen = consoleTable.find(name);
     if (processScreen != consoleTable.end()) {
         if (processScreen->second->isDone()) {
@@ -66,7 +68,8 @@ void ConsoleManager::switchConsole(const std::string& name) {
         else {
             system("cls");
             previousConsole = currentConsole;
-            currentConsole = consoleTable[name];
+            currentConsole = processScreen->second;
+            lock.unlock();  //the screen takes over input from here
             currentConsole->onEnabled();
         }
     }
@@ -108,26 +111,66 @@ void ConsoleManager::setCursorPosition(int posX, int posY) const {
 
 // Creates processes and its respective screen then adds that process to the scheduler
 void ConsoleManager::createProcess(const std::string& processName, int lines, int memory) {
-    int newPID = processes.empty() ? 1001 : processes.back()->getPID() + 1;
+    int newPID = nextPID++;
     currentPID = newPID;
-   
-    // get start time
-    auto now = chrono::system_clock::now();
-    time_t currentTime = chrono::system_clock::to_time_t(now);
-    struct tm buf;
-    localtime_s(&buf, &currentTime);
 
-    char timeStr[100]; // timestamp in timeStr
-    strftime(timeStr, sizeof(timeStr), "%m/%d/%Y %I:%M:%S %p", &buf);
+    auto created = chrono::system_clock::now(); // get start time
 
-    auto newProcess = std::make_shared<Process>(newPID, processName, lines, timeStr, memory);
-    processes.push_back(newProcess);
-    auto processScreen = std::make_shared<BaseScreen>(processName, newProcess);
-    consoleTable[processName] = processScreen;
+    auto newProcess = std::allocate_shared<Process>(PoolAllocator<Process>(), newPID, processName, lines, created, memory, scheduler->generateProgramSeed());
+    auto processScreen = std::allocate_shared<BaseScreen>(PoolAllocator<BaseScreen>(), processName, newProcess);
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        consoleTable[processName] = processScreen;
+    }
 
     scheduler->addProcess(newProcess);
 }
 
+// Creates a whole batch of dummy processes named P<pid>. The PIDs are reserved with one atomic add,
+// the batch shares one creation time, and the batch is published to the scheduler in one call.
+// Processes, screens and console table entries come from the slab pools, so creating one does not go through malloc.
+void ConsoleManager::createProcessBatch(const std::vector<ProcessSpec>& specs) {
+    if (specs.empty()) {
+        return;
+    }
+    int firstPID = nextPID.fetch_add(static_cast<int>(specs.size()));
+    currentPID = firstPID + static_cast<int>(specs.size()) - 1;
+
+    auto created = chrono::system_clock::now();
+    time_t screenTime = chrono::system_clock::to_time_t(created);
+
+    std::vector<std::shared_ptr<Process>> batch;
+    std::vector<std::shared_ptr<BaseScreen>> screens;
+    batch.reserve(specs.size());
+    screens.reserve(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        int pid = firstPID + static_cast<int>(i);
+        std::string name = "P" + std::to_string(pid);
+        batch.push_back(std::allocate_shared<Process>(PoolAllocator<Process>(), pid, name, specs[i].lines, created, specs[i].memory, specs[i].programSeed));
+        screens.push_back(std::allocate_shared<BaseScreen>(PoolAllocator<BaseScreen>(), name, batch.back(), screenTime));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        for (auto& screen : screens) {
+            consoleTable[screen->getName()] = screen;
+        }
+    }
+
+    scheduler->addProcesses(batch);
+}
+
+// Drops the screen of a finished process. With the scheduler's and the memory manager's references
+// gone too, the Process, its screen and its table entry go back to their pools; the reports keep
+// a short record of it in ProcessTable's finished history.
+void ConsoleManager::retireProcess(const std::string& processName) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    auto processScreen = consoleTable.find(processName);
+    if (processScreen != consoleTable.end() && processScreen->second->isDone()) {
+        consoleTable.erase(processScreen);
+    }
+}
+
 // Sets the scheduler based on initialization in Main Console
 void ConsoleManager::setScheduler(Scheduler* scheduler) {
     this->scheduler = scheduler;
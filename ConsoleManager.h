@@ -1,18 +1,32 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#ifndef NOMINMAX
+#define NOMINMAX    // keep Windows.h from defining min and max macros over std::min and std::max
+#endif
 #include <Windows.h>
 #include "AConsole.h"
 #include "Process.h"
 #include "Scheduler.h"
+#include "SlabPool.h"
 
 using namespace std;
 
+// Instructions and memory of one process of a generated batch
+struct ProcessSpec {
+	int lines;
+	int memory;
+	uint64_t programSeed;	// seed the process's bytecode program is generated from
+};
+
 class ConsoleManager {
 public:
 	using String = std::string;
-	using Processes = std::vector<std::shared_ptr<Process>>;
-	using ConsoleTable = std::unordered_map<String, std::shared_ptr<AConsole>>;
+	using ConsoleTable = std::unordered_map<String, std::shared_ptr<AConsole>, std::hash<String>, std::equal_to<String>,
+		PoolAllocator<std::pair<const String, std::shared_ptr<AConsole>>>>;
 
 	static ConsoleManager* getInstance();
 	static void initialize();
@@ -29,12 +43,14 @@ public:
 	void setCursorPosition(int posX, int posY) const;
 
 	void createProcess(const std::string& processName, int lines, int memory);
+	void createProcessBatch(const std::vector<ProcessSpec>& specs);
+	void retireProcess(const std::string& processName);
 	void setScheduler(Scheduler* scheduler);
 
 	int getCurrentPID() const;
 
-	Processes processes;
 	ConsoleTable consoleTable;
+	std::mutex tableMutex;	// guards consoleTable, the generator adds to it while the console reads
 	Scheduler* scheduler;
 
 private:
@@ -49,6 +65,7 @@ private:
 
 	HANDLE consoleHandle;
 	bool running = true;
-	int currentPID = 1000;
+	std::atomic<int> currentPID{ 1000 };
+	std::atomic<int> nextPID{ 1001 };	// PIDs are handed out in blocks with one atomic add
 };
 
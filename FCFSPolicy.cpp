@@ -0,0 +1,31 @@
+#include "FCFSPolicy.h"
+
+void FCFSPolicy::push(std::shared_ptr<Process> process) {
+    ready.push_back(process);
+}
+
+std::shared_ptr<Process> FCFSPolicy::pop() {
+    if (ready.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<Process> process = ready.front();
+    ready.pop_front();
+    return process;
+}
+
+// Thieves also take the oldest process so arrival order holds across cores
+std::shared_ptr<Process> FCFSPolicy::steal() {
+    return pop();
+}
+
+std::shared_ptr<Process> FCFSPolicy::stealCandidate() const {
+    return ready.empty() ? nullptr : ready.front();
+}
+
+size_t FCFSPolicy::size() const {
+    return ready.size();
+}
+
+int FCFSPolicy::timeSlice(const std::shared_ptr<Process>& /*process*/) const {
+    return 0;   //run to completion
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "SchedulingPolicy.h"
+#include <deque>
+
+class FCFSPolicy : public SchedulingPolicy {
+public:
+    void push(std::shared_ptr<Process> process) override;
+    std::shared_ptr<Process> pop() override;
+    std::shared_ptr<Process> steal() override;
+    std::shared_ptr<Process> stealCandidate() const override;
+    size_t size() const override;
+    int timeSlice(const std::shared_ptr<Process>& process) const override;
+
+protected:
+    std::deque<std::shared_ptr<Process>> ready;
+};
@@ -0,0 +1,21 @@
+#include "FIFOReplacement.h"
+
+FIFOReplacement::FIFOReplacement(int frames) : loaded(frames) {}
+
+void FIFOReplacement::onLoad(int frame) {
+    loaded.pushBack(frame);
+}
+
+void FIFOReplacement::onFree(int frame) {
+    loaded.remove(frame);
+}
+
+int FIFOReplacement::victim() {
+    int frame = loaded.front();
+    loaded.remove(frame);
+    return frame;
+}
+
+std::string FIFOReplacement::getName() const {
+    return "fifo";
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "ReplacementPolicy.h"
+
+// Replaces the page that was loaded first, references do not matter
+class FIFOReplacement : public ReplacementPolicy {
+public:
+    explicit FIFOReplacement(int frames);
+    void onLoad(int frame) override;
+    void onFree(int frame) override;
+    int victim() override;
+    std::string getName() const override;
+
+private:
+    FrameList loaded;
+};
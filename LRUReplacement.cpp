@@ -0,0 +1,26 @@
+#include "LRUReplacement.h"
+
+LRUReplacement::LRUReplacement(int frames) : recency(frames) {}
+
+void LRUReplacement::onLoad(int frame) {
+    recency.pushBack(frame);
+}
+
+void LRUReplacement::onTouch(int frame) {
+    recency.remove(frame);
+    recency.pushBack(frame);
+}
+
+void LRUReplacement::onFree(int frame) {
+    recency.remove(frame);
+}
+
+int LRUReplacement::victim() {
+    int frame = recency.front();
+    recency.remove(frame);
+    return frame;
+}
+
+std::string LRUReplacement::getName() const {
+    return "lru";
+}
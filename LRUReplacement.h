@@ -0,0 +1,16 @@
+#pragma once
+#include "ReplacementPolicy.h"
+
+// Replaces the page referenced longest ago; a reference moves the frame to the back of the list
+class LRUReplacement : public ReplacementPolicy {
+public:
+    explicit LRUReplacement(int frames);
+    void onLoad(int frame) override;
+    void onTouch(int frame) override;
+    void onFree(int frame) override;
+    int victim() override;
+    std::string getName() const override;
+
+private:
+    FrameList recency;  // least recently referenced first
+};
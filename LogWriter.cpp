@@ -0,0 +1,181 @@
+#include "LogWriter.h"
+#include <ctime>
+#include <cstdio>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+static const char* OPCODE_NAMES[] = { "PRINT", "DECLARE", "ADD", "SUBTRACT", "SLEEP", "FOR", "END" };
+
+LogWriter* LogWriter::instance = nullptr;
+
+// Records staged by the calling thread since its last publish
+static thread_local std::vector<LogRecord> staged;
+
+// Creates the log folder; it already existing is fine
+static void makeLogFolder(const char* path) {
+#ifdef _WIN32
+    CreateDirectoryA(path, nullptr);
+#else
+    mkdir(path, 0755);
+#endif
+}
+
+LogWriter::LogWriter() {
+    makeLogFolder("memory");
+    backingStoreLog.open("memory/backing-store.log", PREALLOCATE, true);
+    writerThread = std::thread(&LogWriter::run, this);
+}
+
+LogWriter* LogWriter::getInstance() {
+    if (!instance) {
+        instance = new LogWriter();
+    }
+    return instance;
+}
+
+void LogWriter::initialize() {
+    getInstance();
+}
+
+// Flushes and closes every log. The instance is kept since core threads may still log while the
+// program exits; their records are dropped.
+void LogWriter::destroy() {
+    if (instance) {
+        instance->shutdown();
+    }
+}
+
+void LogWriter::log(const LogRecord& record) {
+    staged.push_back(record);
+    if (staged.size() >= PUBLISH_BATCH) {
+        publish();
+    }
+}
+
+void LogWriter::publish() {
+    if (staged.empty()) {
+        return;
+    }
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (!running || pending.size() + staged.size() > MAX_PENDING) {
+            dropped += staged.size();
+            staged.clear();
+            return;
+        }
+        wasEmpty = pending.empty();
+        pending.insert(pending.end(), staged.begin(), staged.end());
+    }
+    staged.clear();
+    if (wasEmpty) {
+        pendingCv.notify_one();
+    }
+}
+
+long long LogWriter::getDropped() const {
+    return dropped;
+}
+
+void LogWriter::run() {
+    std::vector<LogRecord> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingCv.wait(lock, [this] { return !pending.empty() || !running; });
+            if (pending.empty() && !running) {
+                break;
+            }
+            batch.swap(pending);
+        }
+        for (const auto& record : batch) {
+            write(record);
+        }
+        batch.clear();
+    }
+    openLogs.clear();
+    recentLogs.clear();
+    backingStoreLog.close();
+}
+
+void LogWriter::write(const LogRecord& record) {
+    if (record.time != formattedTime) {  //records come in time order, so this runs about once a second
+        time_t recordTime = static_cast<time_t>(record.time);
+        struct tm buf;
+        localtime_s(&buf, &recordTime);
+        strftime(timeStr, sizeof(timeStr), "%m/%d/%Y %I:%M:%S %p", &buf);
+        formattedTime = record.time;
+    }
+    char line[160];
+
+    int length = 0;
+    MappedLog* target = nullptr;
+    switch (record.kind) {
+    case LogRecord::EXECUTION:
+        length = snprintf(line, sizeof(line), "(%s) Core: %d - Executing %s x%u\n",
+            timeStr, record.coreID, OPCODE_NAMES[static_cast<int>(record.op)], record.count);
+        target = logFor(record.pid);
+        break;
+    case LogRecord::FINISH:
+        length = snprintf(line, sizeof(line), "(%s) Core: %d - Finished %u / %u\n",
+            timeStr, record.coreID, record.count, record.total);
+        target = logFor(record.pid);
+        break;
+    case LogRecord::SWAP_OUT:
+        length = snprintf(line, sizeof(line), "%d  |  %u/%u (%s)\n", record.pid, record.count, record.total, timeStr);
+        target = &backingStoreLog;
+        break;
+    case LogRecord::PAGE_OUT:
+        length = snprintf(line, sizeof(line), "%d  |  page %u/%u (%s)\n", record.pid, record.count, record.total, timeStr);
+        target = &backingStoreLog;
+        break;
+    }
+    if (target && length > 0) {
+        target->append(line, static_cast<size_t>(length));
+    }
+
+    if (record.kind == LogRecord::FINISH) {     //nothing more will be written for this process
+        auto found = openLogs.find(record.pid);
+        if (found != openLogs.end()) {
+            recentLogs.erase(found->second.second);
+            openLogs.erase(found);
+        }
+    }
+}
+
+// Open log of a process, opening it (and closing the least recently used one) if needed
+MappedLog* LogWriter::logFor(int pid) {
+    auto found = openLogs.find(pid);
+    if (found != openLogs.end()) {
+        recentLogs.splice(recentLogs.begin(), recentLogs, found->second.second);
+        return found->second.first.get();
+    }
+
+    if (openLogs.size() >= MAX_OPEN_LOGS) {
+        openLogs.erase(recentLogs.back());
+        recentLogs.pop_back();
+    }
+    auto log = std::make_unique<MappedLog>();
+    bool firstOpen = startedLogs.insert(pid).second;   //a log left by an earlier run is overwritten
+    if (!log->open("memory/" + std::to_string(pid) + ".log", PREALLOCATE, firstOpen)) {
+        return nullptr;
+    }
+    recentLogs.push_front(pid);
+    MappedLog* opened = log.get();
+    openLogs[pid] = { std::move(log), recentLogs.begin() };
+    return opened;
+}
+
+void LogWriter::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        running = false;
+    }
+    pendingCv.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
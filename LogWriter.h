@@ -0,0 +1,69 @@
+#pragma once
+#include "MappedLog.h"
+#include "Program.h"
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Fixed-size binary log record. Producers only fill these in; the text is made by the writer thread.
+struct LogRecord {
+    enum Kind : uint8_t { EXECUTION, FINISH, SWAP_OUT, PAGE_OUT };
+    int64_t time;       // time_t
+    int32_t pid;
+    int16_t coreID;
+    Kind kind;
+    Opcode op;          // EXECUTION: opcode of the run
+    uint32_t count;     // EXECUTION: instructions in the run, PAGE_OUT: the page, otherwise instructions executed so far
+    uint32_t total;     // lines of code of the process, PAGE_OUT: its pages
+};
+
+// Background log pipeline. Producers stage records in a per-thread buffer and hand them over in
+// batches; one writer thread formats them and appends them to memory-mapped files in the "memory"
+// folder: one log per process, and backing-store.log for swaps. Producers never wait on the disk.
+class LogWriter {
+public:
+    static LogWriter* getInstance();
+    static void initialize();
+    static void destroy();
+
+    void log(const LogRecord& record);  // stages the record on the calling thread, publishing every PUBLISH_BATCH
+    void publish();                     // hands the calling thread's staged records to the writer
+    long long getDropped() const;
+
+private:
+    LogWriter();
+    void run();
+    void write(const LogRecord& record);
+    MappedLog* logFor(int pid);
+    void shutdown();
+
+    static LogWriter* instance;
+
+    static const size_t PUBLISH_BATCH = 256;
+    static const size_t MAX_PENDING = 1 << 20;  // records beyond this are dropped, not waited on
+    static const size_t MAX_OPEN_LOGS = 64;     // least recently used process logs are closed past this
+    static const size_t PREALLOCATE = 64 * 1024;
+
+    std::mutex pendingMutex;
+    std::condition_variable pendingCv;
+    std::vector<LogRecord> pending;
+    std::atomic<bool> running{ true };
+    std::atomic<long long> dropped{ 0 };
+    std::thread writerThread;
+
+    // only touched by the writer thread
+    std::unordered_map<int, std::pair<std::unique_ptr<MappedLog>, std::list<int>::iterator>> openLogs;
+    std::list<int> recentLogs;          // pids of the open logs, most recently written first
+    std::unordered_set<int> startedLogs;    // logs already created in this run, reopened for appending
+    MappedLog backingStoreLog;
+    int64_t formattedTime = -1;         // time timeStr holds
+    char timeStr[32] = {};
+};
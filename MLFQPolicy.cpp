@@ -0,0 +1,97 @@
+#include "MLFQPolicy.h"
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit, bits must not be 0
+static int lowestSetBit(uint32_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+MLFQPolicy::MLFQPolicy(int quantum) : quantum(std::max(quantum, 1)) {}
+
+void MLFQPolicy::push(std::shared_ptr<Process> process) {
+    int level = std::min(process->getPriority(), NUM_LEVELS - 1);
+    levels[level].push_back(process);
+    nonEmpty |= (1u << level);
+    count++;
+}
+
+std::shared_ptr<Process> MLFQPolicy::pop() {
+    if (nonEmpty == 0) {
+        return nullptr;
+    }
+    if (++picks >= BOOST_PERIOD) {  //keep demoted processes from starving
+        picks = 0;
+        boost();
+    }
+    return popLevel(lowestSetBit(nonEmpty));
+}
+
+// Idle peers take from the lowest level so the short, high-priority work stays local
+std::shared_ptr<Process> MLFQPolicy::steal() {
+    if (nonEmpty == 0) {
+        return nullptr;
+    }
+    return popLevel(lowestPriorityLevel());
+}
+
+std::shared_ptr<Process> MLFQPolicy::stealCandidate() const {
+    if (nonEmpty == 0) {
+        return nullptr;
+    }
+    return levels[lowestPriorityLevel()].front();
+}
+
+// Highest-numbered non-empty level, nonEmpty must not be 0
+int MLFQPolicy::lowestPriorityLevel() const {
+    int level = NUM_LEVELS - 1;
+    while (levels[level].empty()) {
+        level--;
+    }
+    return level;
+}
+
+size_t MLFQPolicy::size() const {
+    return count;
+}
+
+int MLFQPolicy::timeSlice(const std::shared_ptr<Process>& process) const {
+    int level = std::min(process->getPriority(), NUM_LEVELS - 1);
+    return quantum << level;
+}
+
+// A process that used its whole quantum is treated as batch work and demoted
+void MLFQPolicy::onSliceEnd(const std::shared_ptr<Process>& process, int executed) {
+    if (!process->isFinished() && executed >= timeSlice(process) && process->getPriority() < NUM_LEVELS - 1) {
+        process->setPriority(process->getPriority() + 1);
+    }
+}
+
+std::shared_ptr<Process> MLFQPolicy::popLevel(int level) {
+    std::shared_ptr<Process> process = levels[level].front();
+    levels[level].pop_front();
+    if (levels[level].empty()) {
+        nonEmpty &= ~(1u << level);
+    }
+    count--;
+    return process;
+}
+
+void MLFQPolicy::boost() {
+    for (int level = 1; level < NUM_LEVELS; level++) {
+        for (auto& process : levels[level]) {
+            process->setPriority(0);
+            levels[0].push_back(process);
+        }
+        levels[level].clear();
+    }
+    nonEmpty = levels[0].empty() ? 0 : 1u;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "SchedulingPolicy.h"
+#include <deque>
+#include <cstdint>
+
+// Multi-level feedback queue. New processes enter level 0; a process that uses its whole
+// quantum drops one level and gets twice the quantum there. A bitmap of non-empty levels
+// makes picking the next process constant time.
+class MLFQPolicy : public SchedulingPolicy {
+public:
+    static const int NUM_LEVELS = 8;
+    static const int BOOST_PERIOD = 256;    // picks between moving every process back to level 0
+
+    MLFQPolicy(int quantum);
+    void push(std::shared_ptr<Process> process) override;
+    std::shared_ptr<Process> pop() override;
+    std::shared_ptr<Process> steal() override;
+    std::shared_ptr<Process> stealCandidate() const override;
+    size_t size() const override;
+    int timeSlice(const std::shared_ptr<Process>& process) const override;
+    void onSliceEnd(const std::shared_ptr<Process>& process, int executed) override;
+
+private:
+    std::shared_ptr<Process> popLevel(int level);
+    void boost();
+    int lowestPriorityLevel() const;
+
+    int quantum;
+    std::deque<std::shared_ptr<Process>> levels[NUM_LEVELS];
+    uint32_t nonEmpty = 0;      // bit i set when levels[i] has a process
+    size_t count = 0;
+    int picks = 0;
+};
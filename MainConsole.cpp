@@ -56,6 +56,7 @@ MainConsole::Command MainConsole::getCommand(const std::string& input) const {
     else if (word == "screen") return isInitialized ? CMD_SCREEN : CMD_NOT_INITIALIZED;
     else if (word == "scheduler-test") return isInitialized ? CMD_SCHEDULER_TEST : CMD_NOT_INITIALIZED;
     else if (word == "scheduler-stop") return isInitialized ? CMD_SCHEDULER_STOP : CMD_NOT_INITIALIZED;
+    else if (word == "scheduler-replay") return isInitialized ? CMD_SCHEDULER_REPLAY : CMD_NOT_INITIALIZED;
     else if (word == "report-util") return isInitialized ? CMD_REPORT_UTIL : CMD_NOT_INITIALIZED;
     else if (word == "process-smi") return isInitialized ? CMD_PROCESS_SMI : CMD_NOT_INITIALIZED;
     else if (word == "vmstat") return isInitialized ? CMD_VMSTAT : CMD_NOT_INITIALIZED;
@@ -76,6 +77,11 @@ struct Config {
     int memPerFrame = 2;
     int minMemPerProc = 2;
     int maxMemPerProc = 2;
+    int virtualClock = 0;
+    int pinCores = 0;
+    unsigned long long seed = 0;  // 0 draws a fresh seed
+    std::string pageReplacement = "fifo";
+    int workingSetWindow = 0;     // 0 uses one reference per frame
 };
 
 Config readConfig(const std::string& filename) {
@@ -126,6 +132,20 @@ Config readConfig(const std::string& filename) {
         } else if (line.find("max-mem-per-proc") != std::string::npos) {
             iss >> key >> value;
             config.maxMemPerProc = value;
+        } else if (line.find("virtual-clock") != std::string::npos) {
+            iss >> key >> value;
+            config.virtualClock = value;
+        } else if (line.find("pin-cores") != std::string::npos) {
+            iss >> key >> value;
+            config.pinCores = value;
+        } else if (line.find("seed") != std::string::npos) {
+            iss >> key >> config.seed;
+        } else if (line.find("page-replacement") != std::string::npos) {
+            iss >> key >> config.pageReplacement;
+            config.pageReplacement = config.pageReplacement.substr(1, config.pageReplacement.length() - 2);
+        } else if (line.find("working-set-window") != std::string::npos) {
+            iss >> key >> value;
+            config.workingSetWindow = value;
         }
     }
 
@@ -140,7 +160,8 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
         if (scheduler == nullptr) {
             scheduler = new Scheduler(config.numCpu, config.scheduler, config.quantumCycles,
                 config.batchProcessFreq, config.minIns, config.maxIns, config.delayPerExec,
-                config.maxOverallMem, config.memPerFrame, config.minMemPerProc, config.maxMemPerProc);
+                config.maxOverallMem, config.memPerFrame, config.minMemPerProc, config.maxMemPerProc,
+                config.virtualClock != 0, config.pinCores != 0, config.seed, config.pageReplacement, config.workingSetWindow);
             scheduler->startScheduling();
             ConsoleManager::getInstance()->setScheduler(scheduler);
             isInitialized = true;
@@ -148,6 +169,15 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
             if (config.scheduler == "rr") {
                 sched = "Round Robin";
             }
+            else if (config.scheduler == "sjf") {
+                sched = "Shortest Job First";
+            }
+            else if (config.scheduler == "srtf") {
+                sched = "Shortest Remaining Time First";
+            }
+            else if (config.scheduler == "mlfq") {
+                sched = "Multi-Level Feedback Queue";
+            }
             else sched = "First Come First Serve";
 
             std::cout << "Program configuration initialized!\n";
@@ -157,13 +187,16 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
             std::cout << "   Quantum Cycles                - " << config.quantumCycles << std::endl;
             std::cout << "   Frequency of Adding Processes - " << config.batchProcessFreq << std::endl;
             std::cout << "   Range of Instructions         - " << config.minIns << "-" << config.maxIns << std::endl;
-            std::cout << "   Delay per Execution           - " << config.delayPerExec << std::endl << std::endl;
+            std::cout << "   Delay per Execution           - " << config.delayPerExec << std::endl;
+            std::cout << "   Clock                         - " << (config.virtualClock ? "Virtual" : "Real") << std::endl;
+            std::cout << "   Seed                          - " << scheduler->getSeed() << std::endl << std::endl;
 
             std::cout << "Memory settings set to:" << std::endl;
             std::cout << "   Maximum Memory Available      - " << config.maxOverallMem << std::endl;
             std::cout << "   Memory Size per Frame         - " << config.memPerFrame << std::endl;
             std::cout << "   Minimum Size per Process      - " << config.minMemPerProc << std::endl;
-            std::cout << "   Maximum Size Per Process      - " << config.maxMemPerProc << std::endl << std::endl;
+            std::cout << "   Maximum Size Per Process      - " << config.maxMemPerProc << std::endl;
+            std::cout << "   Page Replacement              - " << scheduler->getReplacementName() << std::endl << std::endl;
 
             x = config.batchProcessFreq;
         }
@@ -189,24 +222,36 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
         iss >> parameter; // Process name
 
         if (mode == "-r") {
-            if (ConsoleManager::getInstance()->consoleTable.find(parameter) != ConsoleManager::getInstance()->consoleTable.end()) {
+            bool found;
+            {
+                std::lock_guard<std::mutex> lock(ConsoleManager::getInstance()->tableMutex);
+                auto& consoleTable = ConsoleManager::getInstance()->consoleTable;
+                found = consoleTable.find(parameter) != consoleTable.end();
+            }
+            if (found) {
                 ConsoleManager::getInstance()->switchConsole(parameter);
             }
+            else if (ProcessTable::getInstance()->wasFinished(parameter)) {  //finished and retired
+                std::cout << "Can't access screen '" << parameter << "'. (Already done executing)\n" << std::endl;
+            }
             else {
                 std::cout << "No screen found with the name: " << parameter << "\n" << std::endl;
             }
         }
         else if (mode == "-s") {
-            auto& consoleTable = ConsoleManager::getInstance()->consoleTable;
-            auto screenIt = consoleTable.find(parameter);
-            if (screenIt != consoleTable.end()) {
-                // If the screen exists and is done, remove it and create a new one
-                if (screenIt->second->isDone()) {
-                    consoleTable.erase(screenIt);
-                }
-                else {
-                    std::cout << "ERROR: Screen " << parameter << " already exists and is not finished!\n" << std::endl;
-                    break;
+            {
+                std::lock_guard<std::mutex> lock(ConsoleManager::getInstance()->tableMutex);
+                auto& consoleTable = ConsoleManager::getInstance()->consoleTable;
+                auto screenIt = consoleTable.find(parameter);
+                if (screenIt != consoleTable.end()) {
+                    // If the screen exists and is done, remove it and create a new one
+                    if (screenIt->second->isDone()) {
+                        consoleTable.erase(screenIt);
+                    }
+                    else {
+                        std::cout << "ERROR: Screen " << parameter << " already exists and is not finished!\n" << std::endl;
+                        break;
+                    }
                 }
             }
 
@@ -240,7 +285,6 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
         schedulerThread = std::thread([this]() {
             try {
                 this->scheduler->generateProcesses();
-                this->scheduler->startTicksProcesses();
             }
             catch (const std::exception& e) {
                 std::cerr << "Scheduler error: " << e.what() << std::endl;
@@ -262,6 +306,26 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
         std::cout << std::endl;
         break;
     }
+    case CMD_SCHEDULER_REPLAY: {
+        std::istringstream iss(userInput);
+        std::string command, path;
+        iss >> command;
+        std::getline(iss >> std::ws, path);
+        if (path.empty()) {
+            std::cout << "Usage: scheduler-replay <trace file>\n" << std::endl;
+            break;
+        }
+
+        std::string error;
+        long long arrivals = scheduler->replayTrace(path, error);
+        if (arrivals < 0) {
+            std::cout << "ERROR: Cannot replay " << path << ": " << error << "\n" << std::endl;
+        }
+        else {
+            std::cout << "Scheduler is now replaying " << arrivals << " arrivals from " << path << "...\n" << std::endl;
+        }
+        break;
+    }
     case CMD_REPORT_UTIL: {
         std::cout << "Generating utilization report...\n" << std::endl;
         scheduler->reportUtil();
@@ -288,6 +352,9 @@ void MainConsole::executeCommand(Command command, const std::string& userInput){
         if (schedulerThread.joinable()) {
             schedulerThread.join();
         }
+        if (scheduler != nullptr) {     //core threads retire processes through the console manager, end them first
+            scheduler->shutdown();
+        }
         ConsoleManager::getInstance()->exitApplication();
         break;
     }
@@ -24,6 +24,7 @@ private:
         CMD_SCREEN_ACTIVE,
         CMD_SCHEDULER_TEST,
         CMD_SCHEDULER_STOP,
+        CMD_SCHEDULER_REPLAY,
         CMD_REPORT_UTIL,
         CMD_PROCESS_SMI,
         CMD_VMSTAT,
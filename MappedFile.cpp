@@ -0,0 +1,76 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    bool ok = GetFileSizeEx(file, &fileSize) != 0;
+    length = ok ? static_cast<size_t>(fileSize.QuadPart) : 0;
+    if (ok && length > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        view = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        ok = view != nullptr;
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    bool ok = fstat(file, &info) == 0;
+    length = ok ? static_cast<size_t>(info.st_size) : 0;
+    if (ok && length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        ok = address != MAP_FAILED;
+        view = ok ? static_cast<const char*>(address) : nullptr;
+    }
+    ::close(file);
+#endif
+    if (!ok) {
+        close();
+    }
+    return ok;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (view) {
+        UnmapViewOfFile(view);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+#else
+    if (view) {
+        munmap(const_cast<char*>(view), length);
+    }
+#endif
+    view = nullptr;
+    mapping = nullptr;
+    length = 0;
+}
+
+const char* MappedFile::data() const {
+    return view;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
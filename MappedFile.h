@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. The contents are paged in by the OS on first touch,
+// so large files are read in place without copying them into the heap.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const char* data() const;
+    size_t size() const;
+
+private:
+    const char* view = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;    // mapping handle on Windows, unused elsewhere
+};
@@ -0,0 +1,125 @@
+#include "MappedLog.h"
+#include <cstring>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedLog::~MappedLog() {
+    close();
+}
+
+bool MappedLog::open(const std::string& path, size_t preallocate, bool truncate) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    file = handle;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        close();
+        return false;
+    }
+    used = static_cast<size_t>(fileSize.QuadPart);
+#else
+    file = ::open(path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close();
+        return false;
+    }
+    used = static_cast<size_t>(info.st_size);
+#endif
+    if (!map(used + preallocate)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Grows the file to newCapacity and maps all of it
+bool MappedLog::map(size_t newCapacity) {
+    unmap();
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(newCapacity);
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);     //extends the file
+    if (!mapping) {
+        return false;
+    }
+    view = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+#else
+    if (ftruncate(file, static_cast<off_t>(newCapacity)) != 0) {
+        return false;
+    }
+    void* address = mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    view = address == MAP_FAILED ? nullptr : static_cast<char*>(address);
+#endif
+    capacity = view ? newCapacity : 0;
+    return view != nullptr;
+}
+
+void MappedLog::unmap() {
+#ifdef _WIN32
+    if (view) {
+        UnmapViewOfFile(view);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    mapping = nullptr;
+#else
+    if (view) {
+        munmap(view, capacity);
+    }
+#endif
+    view = nullptr;
+    capacity = 0;
+}
+
+bool MappedLog::append(const char* text, size_t length) {
+    if (!view) {
+        return false;
+    }
+    if (used + length > capacity && !map((used + length) * 2)) {
+        return false;
+    }
+    std::memcpy(view + used, text, length);
+    used += length;
+    return true;
+}
+
+// Unmaps and cuts the preallocated tail off the file
+void MappedLog::close() {
+    unmap();
+#ifdef _WIN32
+    if (file) {
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(used);
+        SetFilePointerEx(file, end, nullptr, FILE_BEGIN);
+        SetEndOfFile(file);
+        CloseHandle(file);
+    }
+    file = nullptr;
+#else
+    if (file >= 0) {
+        ftruncate(file, static_cast<off_t>(used));
+        ::close(file);
+    }
+    file = -1;
+#endif
+    used = 0;
+}
+
+bool MappedLog::isOpen() const {
+    return view != nullptr;
+}
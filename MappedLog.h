@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// Append-only log file written through a writable memory mapping. The file is preallocated in
+// chunks so an append is a memcpy; it is trimmed to the written length when closed.
+class MappedLog {
+public:
+    MappedLog() = default;
+    ~MappedLog();
+    MappedLog(const MappedLog&) = delete;
+    MappedLog& operator=(const MappedLog&) = delete;
+
+    bool open(const std::string& path, size_t preallocate, bool truncate);  // appends unless truncate
+    bool append(const char* text, size_t length);
+    void close();
+    bool isOpen() const;
+
+private:
+    bool map(size_t newCapacity);
+    void unmap();
+
+    char* view = nullptr;
+    size_t used = 0;
+    size_t capacity = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int file = -1;
+#endif
+};
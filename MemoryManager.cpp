@@ -5,63 +5,183 @@
 #include <chrono>
 #include <fstream>
 #include <ctime>
-// Constructor: Initialize memory with -1 (indicating free space)
-MemoryManager::MemoryManager(int maxMemory, int frameSize, int availableMemory)
-    : memory(maxMemory / frameSize, -1), maxMemory(maxMemory), frameSize(frameSize),
-    availableMemory(availableMemory) {
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit, bits must not be 0
+static int lowestSetBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Smallest buddy block: 1, doubled until memory is at most 65536 of them
+static int buddyMinBlock(int maxMemory) {
+    int minBlock = 1;
+    while (maxMemory / minBlock > 65536) {
+        minBlock *= 2;
+    }
+    return minBlock;
+}
+
+// Constructor: Initialize every frame as free
+MemoryManager::MemoryManager(int maxMemory, int frameSize, int availableMemory, const std::string& pageReplacement, int workingSetWindow)
+    : buddy(maxMemory == frameSize ? maxMemory : 0, buddyMinBlock(maxMemory)),
+    availableMemory(availableMemory), maxMemory(maxMemory), frameSize(frameSize) {
     if (maxMemory == frameSize) {
         memType = "flat";
     }
     else {
         memType = "paging";
     }
+    freeFrameCount = maxMemory / frameSize;
+    freeFrames.assign((freeFrameCount + 63) / 64, ~0ULL);
+    frameTable.resize(freeFrameCount);
+    replacement = ReplacementPolicy::create(pageReplacement, freeFrameCount, workingSetWindow);
+    if (freeFrameCount % 64 != 0) {     //frames past the end are never free
+        freeFrames.back() = (1ULL << (freeFrameCount % 64)) - 1;
+    }
 }
 
 // allocate based on type
 bool MemoryManager::allocate(std::shared_ptr<Process> process) {
-    bool isExistingAndRunning = false;
-    for (auto& p : processes) {
-        if (p.active == "running") {
-            p.time++;
-			if (p.pid == process->getPID()) {
-				isExistingAndRunning = true;
-			}
-        }
-    }
-
-    if (isExistingAndRunning) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* existing = findProc(process->getPID());
+    if (existing != nullptr && existing->status == Residency::RUNNING) {
         return false;
     }
-     
+
     bs.addProcess(process, process->getPID());
 
+    allocating = true;  //evictions below make room for this process, not for the waiters
+    bool allocated;
     if (memType == "flat") {
-        return flatAllocate(process->getPID(), process->getMemorySize());
+        allocated = flatAllocate(process->getPID(), process->getMemorySize());
     }
-    return pagingAllocate(process->getPID(), process->getMemorySize());
+    else {
+        allocated = pagingAllocate(process->getPID(), process->getMemorySize());
+    }
+    allocating = false;
+    return allocated;
 }
 
-// First-fit memory allocation
-bool MemoryManager::flatAllocate(int pid, int processSize) {
-    if (isAllocatedIdle(pid)) {
-        setStatus(pid, "running");
+// Allocates or, if that cannot succeed until something is released, parks the process in the memory-wait list
+bool MemoryManager::allocateOrWait(std::shared_ptr<Process> process) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    if (allocate(process)) {
         return true;
     }
-    
-    if (availableMemory >= processSize) {
-        bool existing = false;
-        for (auto& p : processes) {
-            if (p.pid == pid && p.active == "removed") {
-                p.active = "running";
-                existing = true;
+    memoryWaiters[process->getMemorySize()].push_back({ waitSeq++, process });
+    return false;
+}
+
+void MemoryManager::setWakeCallback(std::function<void(std::shared_ptr<Process>)> callback) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    onMemoryFreed = callback;
+}
+
+// Memory an allocation could get right now: free memory plus whatever idle residents hold
+int MemoryManager::reclaimableMemory() {
+    return availableMemory + idleMemory;
+}
+
+Proc* MemoryManager::findProc(int pid) {
+    auto found = processes.find(pid);
+    return found != processes.end() ? &found->second : nullptr;
+}
+
+// Entry of a process being brought in, created on its first allocation
+Proc& MemoryManager::recordProc(int pid, int processSize) {
+    Proc& proc = processes[pid];
+    proc.pid = pid;
+    proc.memory = processSize;
+    setResidency(proc, Residency::RUNNING);
+    return proc;
+}
+
+// Memory an idle process gives back when it is evicted. Paging frames are replaced a page at a
+// time instead, so idle processes there hold nothing reclaimable by eviction.
+int MemoryManager::residentSize(const Proc& proc) const {
+    return memType == "flat" ? proc.blockSize : 0;
+}
+
+// Changes a process's status, moving it on or off the idle list; a process that goes idle
+// is put at the tail, so the head is always the one idle the longest
+void MemoryManager::setResidency(Proc& proc, Residency status) {
+    if (proc.status == Residency::IDLE) {
+        (proc.idlePrev ? proc.idlePrev->idleNext : idleHead) = proc.idleNext;
+        (proc.idleNext ? proc.idleNext->idlePrev : idleTail) = proc.idlePrev;
+        proc.idlePrev = proc.idleNext = nullptr;
+        idleMemory -= residentSize(proc);
+    }
+    proc.status = status;
+    if (status == Residency::IDLE) {
+        proc.idlePrev = idleTail;
+        (idleTail ? idleTail->idleNext : idleHead) = &proc;
+        idleTail = &proc;
+        idleMemory += residentSize(proc);
+    }
+}
+
+// Called whenever memory is released or becomes evictable. Wakes, oldest first, the waiting
+// processes that fit in what can be reclaimed; the smallest request is checked first so a
+// release that helps nobody costs one comparison.
+void MemoryManager::wakeWaiters() {
+    if (allocating || memoryWaiters.empty() || !onMemoryFreed) {
+        return;
+    }
+    int reclaimable = reclaimableMemory();
+    if (memoryWaiters.begin()->first > reclaimable) {
+        return;
+    }
+
+    std::vector<std::pair<long long, std::shared_ptr<Process>>> candidates;
+    for (auto it = memoryWaiters.begin(); it != memoryWaiters.end() && it->first <= reclaimable; ++it) {
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(candidates.begin(), candidates.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (auto& candidate : candidates) {
+        int size = candidate.second->getMemorySize();
+        if (size > reclaimable) {
+            continue;
+        }
+        reclaimable -= size;
+        auto& waiting = memoryWaiters[size];
+        for (auto it = waiting.begin(); it != waiting.end(); ++it) {
+            if (it->first == candidate.first) {
+                waiting.erase(it);
                 break;
             }
         }
-        if (!existing) {
-            processes.push_back({ pid, processSize, "running", 1 }); // Record process information
+        if (waiting.empty()) {
+            memoryWaiters.erase(size);
         }
+        onMemoryFreed(candidate.second);
+    }
+}
+
+// Buddy allocation: the process gets a block of its size rounded up to a power of two
+bool MemoryManager::flatAllocate(int pid, int processSize) {
+    if (isAllocatedIdle(pid)) {
+        setStatus(pid, Residency::RUNNING);
+        return true;
+    }
+    
+    int address = buddy.allocate(processSize);
+    if (address >= 0) {
+        Proc& proc = recordProc(pid, processSize); // Record process information
+        proc.address = address;
+        proc.blockSize = buddy.blockSize(processSize);
         numPagedIn++;
-        availableMemory -= processSize;
+        availableMemory -= proc.blockSize;
         return true;
     } 
     
@@ -73,124 +193,160 @@ bool MemoryManager::flatAllocate(int pid, int processSize) {
     return false;
 }
 
-// Paging memory allocation
+// Paging memory allocation. Nothing is loaded up front: the process gets an empty page table and
+// its pages are brought in as its instructions touch them, so it may be larger than all of memory.
 bool MemoryManager::pagingAllocate(int pid, int processSize) {
-    int requiredFrames = (processSize + frameSize - 1) / frameSize; // Calculate the number of frames needed (ceil division)
-    int freeFrames = 0;
-    int frameCtr = 0;
-    std::vector<int> listOfFrames;
+    int pages = (processSize + frameSize - 1) / frameSize; // Calculate the number of pages (ceil division)
 
     if (isAllocatedIdle(pid)) {
-        setStatus(pid, "running");
+        setStatus(pid, Residency::RUNNING);
         return true;
     }
 
-    for (int i = 0; i < memory.size(); ++i) {
-        if (memory[i] == -1) { // Frame is free
-            listOfFrames.push_back(i);
-            ++freeFrames;
-            if (freeFrames == requiredFrames) { // Enough frames found
-                for (int j = 0; j < memory.size(); ++j) {
-                    if (listOfFrames[frameCtr] == j) {
-                        memory[j] = pid; // Allocate frames to the process
-                        frameCtr++;
-                        if (frameCtr == listOfFrames.size()) {
-                            break;
-                        }
-                    }
-                }
-
-                bool existing = false;
-                for (auto& p : processes) {
-                    if (p.pid == pid && p.active == "removed") {
-                        p.active = "running";
-                        existing = true;
-                        break;
-                    }
-                }
-                if (!existing) {    // Process ID, Process Size, Allocation status, time
-                    processes.push_back({ pid, processSize, "running", 1 }); // Record process information
-                }
-                
-                availableMemory -= processSize;
-                numPagedIn += requiredFrames;
-                return true; // Allocation successful
-            }
-            //std::cout << "total now " << i << std::endl;
+    Proc& proc = recordProc(pid, processSize); // Record process information
+    proc.pageTable.assign(pages, -1);
+    proc.residentPages = 0;
+    return true; // Allocation successful
+}
+
+// Makes the pages a run of instructions touches resident. The instruction stream walks the address
+// space: instruction n sits at byte n * sizeof(Instruction), wrapping at the end of the process.
+// Every move of the stream onto a page is one reference, so a run that wraps comes back to pages it
+// already touched and the replacement policy sees those re-references.
+void MemoryManager::touchPages(int pid, int firstInstruction, int count) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* proc = findProc(pid);
+    if (memType == "flat" || proc == nullptr || proc->pageTable.empty() || count <= 0) {
+        return;
+    }
+    int pages = static_cast<int>(proc->pageTable.size());
+    long long span = (long long)pages * frameSize;
+    long long firstByte = (long long)firstInstruction * sizeof(Instruction) % span;
+    long long lastByte = firstByte + (long long)count * sizeof(Instruction) - 1;
+
+    for (long long step = firstByte / frameSize; step <= lastByte / frameSize; step++) {
+        int page = static_cast<int>(step % pages);
+        pageReferences++;
+        if (proc->pageTable[page] < 0) {
+            pageIn(*proc, page);
+        }
+        else {
+            replacement->onTouch(proc->pageTable[page]);
         }
     }
 
-    // If allocation fails, reallocate by removing oldest process
-    if (!isAllRunning() && freeFrames != requiredFrames) {
-        deallocateOldest();
-        return pagingAllocate(pid, processSize);
+    int frame;
+    while ((frame = replacement->expired()) >= 0) {    //pages the policy no longer keeps
+        writeOut(frame);
+        freeFrame(frame);
     }
-    return false;
 }
 
-// Returns if process is already in the memory or not
-bool MemoryManager::isAllocated(int pid) {
-    bool allocated = false;
-    for (auto& p : processes) {
-        if (p.pid == pid && p.active == "removed") {
-            return false;
-        }
+// Page fault: loads a page into a free frame, or into a frame the replacement policy gives up
+void MemoryManager::pageIn(Proc& proc, int page) {
+    proc.faults++;
+    pageFaults++;
+    int frame = freeFrameCount > 0 ? takeFrame() : evictPage();
+    frameTable[frame].pid = proc.pid;
+    frameTable[frame].page = page;
+    replacement->onLoad(frame);
+    proc.pageTable[page] = frame;
+    proc.residentPages++;
+    availableMemory -= frameSize;
+    numPagedIn++;
+}
 
-        if (p.pid == pid && (p.active == "running" || p.active == "idle")) {
-            allocated = true;
-            break;
-        }
-    }
-    return allocated;
+// Frees the frame the replacement policy picks and hands it over
+int MemoryManager::evictPage() {
+    int frame = replacement->victim();
+    writeOut(frame);
+    availableMemory += frameSize;
+    return frame;
 }
 
-bool MemoryManager::isAllocatedIdle(int pid) {
-    bool allocated = false;
-    for (auto& p : processes) {
-        if (p.pid == pid && p.active == "idle") {
-            allocated = true;
-            break;
-        }
+// Writes a frame's page out to the backing store and unmaps it from its process
+void MemoryManager::writeOut(int frame) {
+    FrameEntry& entry = frameTable[frame];
+    Proc* owner = findProc(entry.pid);
+    if (owner != nullptr) {
+        owner->pageTable[entry.page] = -1;
+        owner->residentPages--;
+        bs.storePage(entry.pid, entry.page, static_cast<int>(owner->pageTable.size()));
     }
-    return allocated;
+    entry.pid = entry.page = -1;
+    numPagedOut++;
 }
 
-bool MemoryManager::isAllRunning() {
-    int count = 0;
-    int numCtr = 0;
-    for (auto& p : processes) {
-        count++;
-        if (p.active == "running") {
-            numCtr++;
-        }
-        if (p.active == "removed") {
-            count--;
-        }
+// Returns a frame to the bitmap
+void MemoryManager::freeFrame(int frame) {
+    freeFrames[frame / 64] |= 1ULL << (frame % 64);
+    firstFreeWord = std::min(firstFreeWord, static_cast<size_t>(frame / 64));
+    freeFrameCount++;
+    availableMemory += frameSize;
+}
+
+// Takes the lowest free frame. Whole words of taken frames are skipped at once and the free
+// frame of a word is picked with count-trailing-zeros; the caller checked freeFrameCount.
+int MemoryManager::takeFrame() {
+    freeFrameCount--;
+    size_t word = firstFreeWord;
+    while (freeFrames[word] == 0) {
+        ++word;
     }
-    return (count == numCtr);
+    uint64_t bits = freeFrames[word];
+    int frame = static_cast<int>(word * 64) + lowestSetBit(bits);
+    freeFrames[word] = bits & (bits - 1);   //clear the frame just taken
+    firstFreeWord = freeFrames[word] == 0 ? word + 1 : word;
+    return frame;
 }
 
-void MemoryManager::setStatus(int pid, const std::string& status) {
-    for (auto& p : processes) {
-        if (p.pid == pid) {
-            p.active = status;
-            break;
+// Gives the frames of a finishing process back to the bitmap; nothing is written out
+void MemoryManager::releaseFrames(Proc& proc) {
+    for (int& frame : proc.pageTable) {
+        if (frame < 0) {
+            continue;
         }
+        replacement->onFree(frame);
+        frameTable[frame].pid = frameTable[frame].page = -1;
+        freeFrame(frame);
+        frame = -1;
     }
+    proc.residentPages = 0;
 }
 
-void MemoryManager::deallocateOldest() {
-    int highest = 0;
-    int oldestProcess = 0;
+// Returns if process is already in the memory or not
+bool MemoryManager::isAllocated(int pid) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* proc = findProc(pid);
+    return proc != nullptr && proc->status != Residency::REMOVED;
+}
 
-    for (auto& p : processes) {
-        if (p.time > highest && p.active == "idle") {
-            highest = p.time;
-            oldestProcess = p.pid;
-        }
+bool MemoryManager::isAllocatedIdle(int pid) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* proc = findProc(pid);
+    return proc != nullptr && proc->status == Residency::IDLE;
+}
+
+bool MemoryManager::isAllRunning() {
+    return idleHead == nullptr;
+}
+
+void MemoryManager::setStatus(int pid, Residency status) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* proc = findProc(pid);
+    if (proc == nullptr || proc->status == Residency::REMOVED) {
+        return;
     }
+    setResidency(*proc, status);
+    if (status == Residency::IDLE) { //an idle resident can be evicted for a waiting process
+        wakeWaiters();
+    }
+}
 
-    if (oldestProcess != 0) {
+// Evicts the process that has been idle the longest
+void MemoryManager::deallocateOldest() {
+    if (idleHead != nullptr) {
+        int oldestProcess = idleHead->pid;
         bs.storeProcess(oldestProcess);     //backing store
         deallocateMemory(oldestProcess);    //deallocate now
     }
@@ -198,36 +354,32 @@ void MemoryManager::deallocateOldest() {
 
 // Deallocate memory when the process finishes
 void MemoryManager::deallocateMemory(int pid) {
-    int freedMemory = 0;
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    Proc* proc = findProc(pid);
+    if (proc == nullptr || proc->status == Residency::REMOVED) {
+        return;
+    }
+    setResidency(*proc, Residency::REMOVED);    // Remove the process from the active list
 
     if (memType == "flat") {
-        for (auto& p : processes) {
-            if (p.pid == pid) {
-                freedMemory = p.memory;
-                numPagedOut++;
-                break;
-            }
-        }
+        buddy.deallocate(proc->address);
+        availableMemory += proc->blockSize;
+        proc->address = -1;
+        numPagedOut++;
     }
     else {
-        for (int i = 0; i < memory.size(); ++i) {
-            if (memory[i] == pid) {
-                memory[i] = -1;
-                freedMemory += frameSize;
-                numPagedOut++;
-            }
-        }
+        releaseFrames(*proc);
     }
-   
-    availableMemory += freedMemory;
+    wakeWaiters();
+}
 
-    // Remove the process from the active list
-    for (auto& p : processes) {
-        if (p.pid == pid) {
-            p.active = "removed";
-            break;
-        }
-    }
+// Forgets a finished process, so the table only holds processes that can still run,
+// and drops the backing store's reference so the process can be recycled
+void MemoryManager::retireProcess(int pid) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    deallocateMemory(pid);
+    processes.erase(pid);
+    bs.removeProcess(pid);
 }
 
 int MemoryManager::getAvailableMemory() const { 
@@ -253,19 +405,47 @@ float MemoryManager::getMemoryUtil() const {
 }
 
 void MemoryManager::printMemoryDetails(float cpuUtil) {
+    std::lock_guard<std::recursive_mutex> lock(memoryMutex);
+    std::vector<const Proc*> resident;
+    int internalFragmentation = 0;  // block space the processes do not use
+    for (const auto& entry : processes) {
+        if (entry.second.status != Residency::REMOVED) {
+            resident.push_back(&entry.second);
+            internalFragmentation += entry.second.blockSize > 0 ? entry.second.blockSize - entry.second.memory : 0;
+        }
+    }
+    std::sort(resident.begin(), resident.end(), [](const Proc* a, const Proc* b) { return a->pid < b->pid; });
+
     std::cout << "----------------------------------------------" << std::endl;
     std::cout << "| PROCESS-SMI v01.00   Driver Version: 01.00 |" << std::endl;
     std::cout << "----------------------------------------------" << std::endl;
     std::cout << "CPU-Util: " << cpuUtil << "%" << std::endl;
     std::cout << "Memory Usage: " << getUsedMemory() << "KB / " << getMaxMemory() << "KB" << std::endl;
-    std::cout << "Memory Util: " << getMemoryUtil() << "%" << std::endl << std::endl;
+    std::cout << "Memory Util: " << getMemoryUtil() << "%" << std::endl;
+    if (memType == "flat") {    //free memory split into blocks too small for a request is external fragmentation
+        int freeSize = buddy.getFreeSize();
+        int largest = buddy.largestFreeBlock();
+        std::cout << "Largest Free Block: " << largest << "KB" << std::endl;
+        std::cout << "Internal Fragmentation: " << internalFragmentation << "KB" << std::endl;
+        std::cout << "External Fragmentation: " << (freeSize > 0 ? 100.0f * (freeSize - largest) / freeSize : 0.0f) << "%" << std::endl;
+    }
+    std::cout << std::endl;
     std::cout << "==============================================" << std::endl;
     std::cout << "Running processes and memory usage:" << std::endl;
     std::cout << "----------------------------------------------" << std::endl;
-    for (const auto& p : processes) {
-        if (p.active == "running" || p.active == "idle") {
-            std::cout << p.pid << "\t" << p.memory << "KB" << std::endl;
+    for (const Proc* p : resident) {
+        std::shared_ptr<Process> process = bs.getProcess(p->pid);
+        std::cout << p->pid << "\t" << p->memory << "KB";
+        if (p->address >= 0) {
+            std::cout << "\tblock: " << p->address << "-" << p->address + p->blockSize - 1;
+        }
+        if (!p->pageTable.empty()) {
+            std::cout << "\tresident: " << p->residentPages << "/" << p->pageTable.size() << " pages\tfaults: " << p->faults;
+        }
+        if (process != nullptr) {
+            std::cout << "\tmigrations: " << process->getMigrations();
         }
+        std::cout << std::endl;
     }
     std::cout << "----------------------------------------------" << std::endl << std::endl;
 }
@@ -275,4 +455,16 @@ int MemoryManager::getPagedIn() const {
 }
 int MemoryManager::getPagedOut() const {
     return numPagedOut;
+}
+
+long long MemoryManager::getPageFaults() const {
+    return pageFaults;
+}
+
+long long MemoryManager::getPageReferences() const {
+    return pageReferences;
+}
+
+std::string MemoryManager::getReplacementName() const {
+    return replacement->getName();
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "Process.h"
 #include "BackingStore.h"
+#include "ReplacementPolicy.h"
+#include "BuddyAllocator.h"
 #include <vector>
 #include <string>
 #include <ctime>
@@ -8,18 +10,51 @@
 #include <fstream>
 #include <thread>
 #include <mutex>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <functional>
+
+// Where a process's memory is
+enum class Residency : uint8_t {
+    RUNNING,    // in memory and on a core
+    IDLE,       // in memory but off the cores, so it can be evicted
+    REMOVED     // swapped out to the backing store; in paging mode, finished
+};
 
 struct Proc {
     int pid;               // Process ID
     int memory;            // Process size
-    std::string active;           // Indicates if the process is in memory: "running", "idle", "removed"
-    long long time;        // Indicates how long this process has been residing in the memory
+    Residency status = Residency::RUNNING;
+    int address = -1;           // start of the buddy block while resident, flat only
+    int blockSize = 0;          // size of that block, the process size rounded up to a power of two
+    std::vector<int> pageTable; // frame of each page, -1 while the page is not in memory; paging only
+    int residentPages = 0;
+    long long faults = 0;
+    Proc* idlePrev = nullptr;   // list of idle residents, least recently idle first
+    Proc* idleNext = nullptr;
+};
+
+// Owner of a frame in paging mode
+struct FrameEntry {
+    int pid = -1;
+    int page = -1;
 };
 
 class MemoryManager {
 private:
-    std::vector<int> memory;            // Memory is represented as an array of frames
-    std::vector<Proc> processes;
+    std::vector<uint64_t> freeFrames;   // Memory is represented as a bitmap of frames, a set bit is a free frame
+    int freeFrameCount = 0;
+    size_t firstFreeWord = 0;           // no free frame in the words before this one
+    std::vector<FrameEntry> frameTable;
+    std::unique_ptr<ReplacementPolicy> replacement;     // picks the page to write out when memory is full
+    long long pageFaults = 0;
+    long long pageReferences = 0;
+    BuddyAllocator buddy;               // placement of the processes in flat mode
+    std::unordered_map<int, Proc> processes;    // by PID, from first allocation until the process retires
+    Proc* idleHead = nullptr;           // next to evict
+    Proc* idleTail = nullptr;
+    int idleMemory = 0;                 // held by idle residents, reclaimable by eviction
     std::vector<std::shared_ptr<Process>> processVector;
     int totalFragmentation = 0; //might remove since there is nothing in specs that asks for this
     int availableMemory = -1; // default value just for initialization
@@ -34,19 +69,42 @@ private:
 
     BackingStore bs = BackingStore();
 
+    // Processes blocked on memory, by requested size; each entry keeps its arrival order in the list
+    std::map<int, std::deque<std::pair<long long, std::shared_ptr<Process>>>> memoryWaiters;
+    long long waitSeq = 0;
+    bool allocating = false;
+    std::function<void(std::shared_ptr<Process>)> onMemoryFreed;   // hands woken processes back to the scheduler
+    std::recursive_mutex memoryMutex;   // taken by the dispatcher and by the core threads
+
     bool flatAllocate(int pid, int processSize);
     bool pagingAllocate(int pid, int processSize);
+    int takeFrame();
+    void releaseFrames(Proc& proc);
+    void pageIn(Proc& proc, int page);
+    int evictPage();
+    void writeOut(int frame);
+    void freeFrame(int frame);
+    Proc* findProc(int pid);
+    Proc& recordProc(int pid, int processSize);
+    int residentSize(const Proc& proc) const;
+    void setResidency(Proc& proc, Residency status);
     void deallocateOldest();
     bool isAllRunning();
+    int reclaimableMemory();
+    void wakeWaiters();
 
 public:
-    MemoryManager(int maxMemory, int frameSize, int availableMemory);
+    MemoryManager(int maxMemory, int frameSize, int availableMemory, const std::string& pageReplacement = "fifo", int workingSetWindow = 0);
     bool allocate(std::shared_ptr<Process> process);
+    bool allocateOrWait(std::shared_ptr<Process> process);
+    void setWakeCallback(std::function<void(std::shared_ptr<Process>)> callback);
     bool isAllocated(int pid);
     bool isAllocatedIdle(int pid);
     void deallocateMemory(int pid);
+    void retireProcess(int pid);
 
-    void setStatus(int pid, const std::string& status);
+    void setStatus(int pid, Residency status);
+    void touchPages(int pid, int firstInstruction, int count);
 
     int getAvailableMemory() const;
     void setAvailableMemory(int free);
@@ -57,6 +115,9 @@ public:
 
     int getPagedIn() const;
     int getPagedOut() const;
+    long long getPageFaults() const;
+    long long getPageReferences() const;
+    std::string getReplacementName() const;
 
     void printMemoryDetails(float cpuUtil);
 };
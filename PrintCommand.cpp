@@ -1,29 +1,53 @@
 #include "PrintCommand.h"
+#include "LogWriter.h"
 #include <iostream>
 #include <string>
 #include <ctime>
-#include <chrono>
-#include <sstream>
-#include <vector>
-#include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
-PrintCommand::PrintCommand(const std::string& str) : name(str) {}
+const int PrintCommand::LOG_CAPACITY;     // passed to std::min by reference
 
-void PrintCommand::execute(int coreID) {
-    std::ostringstream message;
-    struct tm buf;
-    char timeStr[100];
+static const char* OPCODE_NAMES[] = { "PRINT", "DECLARE", "ADD", "SUBTRACT", "SLEEP", "FOR", "END" };
 
-    auto now = std::chrono::system_clock::now();
-    auto currentTime = std::chrono::system_clock::to_time_t(now);
-    
-    localtime_s(&buf, &currentTime);
-    strftime(timeStr, sizeof(timeStr), "%m/%d/%Y %I:%M:%S %p", &buf);
+PrintCommand::PrintCommand(const std::string& str, int pid) : name(str), pid(pid) {}
 
-    message << "(" << timeStr << ") Core: " << coreID
-        << " - Executing command for process \"" << name << "\"";
+// Adds a run of executions, merged into the newest record when it is the same second, core and opcode.
+// The run is also staged for the process's log file.
+void PrintCommand::record(int coreID, Opcode op, int count, int64_t time) {
+    LogWriter::getInstance()->log({ time, pid, static_cast<int16_t>(coreID), LogRecord::EXECUTION, op, static_cast<uint32_t>(count), 0 });
+    if (used > 0) {
+        LogEntry& newest = entries[(head + LOG_CAPACITY - 1) % LOG_CAPACITY];
+        if (newest.time == time && newest.coreID == coreID && newest.op == op) {
+            newest.count += count;
+            return;
+        }
+    }
+    entries[head] = { time, static_cast<int16_t>(coreID), op, 0, static_cast<uint32_t>(count) };
+    head = (head + 1) % LOG_CAPACITY;
+    used = std::min(used + 1, LOG_CAPACITY);
+}
 
-    output.push_back(message.str());
-}
\ No newline at end of file
+// Formats the kept records, oldest first
+void PrintCommand::print(std::ostream& out) const {
+    for (int i = 0; i < used; i++) {
+        const LogEntry& entry = entries[(head - used + i + LOG_CAPACITY) % LOG_CAPACITY];
+        time_t entryTime = static_cast<time_t>(entry.time);
+        struct tm buf;
+        char timeStr[100];
+        localtime_s(&buf, &entryTime);
+        strftime(timeStr, sizeof(timeStr), "%m/%d/%Y %I:%M:%S %p", &buf);
+
+        out << "(" << timeStr << ") Core: " << entry.coreID
+            << " - Executing " << OPCODE_NAMES[static_cast<int>(entry.op)] << " for process \"" << name << "\"";
+        if (entry.count > 1) {
+            out << " x" << entry.count;
+        }
+        out << "\n";
+    }
+}
+
+int PrintCommand::size() const {
+    return used;
+}
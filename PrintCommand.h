@@ -1,13 +1,33 @@
 #pragma once
 #include <string>
-#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "Program.h"
 
+// One execution record: a run of the same opcode on one core within one second
+struct LogEntry {
+	int64_t time;		// time_t of the run
+	int16_t coreID;
+	Opcode op;
+	uint8_t unused;
+	uint32_t count;		// instructions in the run
+};
+
+// Execution log of one process: fixed-size binary records in a ring buffer, turned into text
+// only when a screen or log asks for it
 class PrintCommand {
 public:
-	PrintCommand(const std::string& str);
-	void execute(int coreID);
+	static const int LOG_CAPACITY = 64;	// newest runs kept, older ones are overwritten
+
+	PrintCommand(const std::string& str, int pid);
+	void record(int coreID, Opcode op, int count, int64_t time);
+	void print(std::ostream& out) const;
+	int size() const;
 
 private:
 	std::string name;
-	std::vector<std::string> output;
+	int pid;
+	LogEntry entries[LOG_CAPACITY];
+	int head = 0;		// slot the next record goes to
+	int used = 0;
 };
\ No newline at end of file
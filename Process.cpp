@@ -4,44 +4,64 @@
 #include <iostream>
 #include <chrono>
 #include <mutex>
+#include <algorithm>
 #include "PrintCommand.h"
 
 using namespace std;
 
-Process::Process(int pid, const std::string& name, int lines, const std::string& startTime, int memory) {
-    this->pid = pid;
-    this->name = name;
-    this->currentState = READY;
-    this->commandCounter = 0;
-    this->linesOfCode = lines;
-    this->coreID = -1;
-    this->startTime = startTime;
+Process::Process(int pid, const std::string& name, int lines, std::chrono::system_clock::time_point created, int memory, uint64_t programSeed)
+    : name(name), command(name, pid) {
+    ProcessTable* table = ProcessTable::getInstance();
+    hot = table->allocate();
+    hot->pid = pid;
+    hot->name = table->internName(name);
+    hot->linesOfCode = lines;
+    hot->commandCounter = 0;
+    hot->coreID = -1;
+    hot->priority = 0;
+    hot->lastCoreID = -1;
+    hot->migrations = 0;
+    hot->readyTick = hot->arrivalTick = hot->finishTick = hot->runTicks = 0;
+    hot->created = created;
+    hot->ended = {};
+    hot->state.store(READY, std::memory_order_release);     //publishes the slot to table scans
     this->memorySize = memory;
-    command = new PrintCommand(name);
+    program = Program::intern(programSeed, lines);
+}
+
+// A finished process was already recorded in the table's history when it was retired
+Process::~Process() {
+    ProcessTable::getInstance()->release(hot);
 }
 
 bool Process::isFinished() const {
-    return currentState == FINISHED;
+    return getState() == FINISHED;
 }
 
 int Process::getPID() const {
-    return pid;
+    return hot->pid;
 }
 
 int Process::getCommandCounter() const {
-    return commandCounter;
+    return hot->commandCounter.load(std::memory_order_relaxed);
 }
 
 int Process::getLinesOfCode() const {
-    return linesOfCode;
+    return hot->linesOfCode;
 }
 
 void Process::setState(ProcessState newState) {
-    currentState = newState;
+    hot->state.store(newState, std::memory_order_release);
+}
+
+// Atomic state change, only made if the process is still in the from state
+bool Process::transition(ProcessState from, ProcessState to) {
+    int expected = from;
+    return hot->state.compare_exchange_strong(expected, to, std::memory_order_acq_rel);
 }
 
 Process::ProcessState Process::getState() const {
-    return currentState;
+    return static_cast<ProcessState>(hot->state.load(std::memory_order_acquire));
 }
 
 std::string Process::getName() const {
@@ -49,67 +69,242 @@ std::string Process::getName() const {
 }
 
 void Process::setCoreID(int coreID) {
-    this->coreID = coreID;
+    hot->coreID.store(coreID, std::memory_order_relaxed);
+}
+
+const ProcessHot& Process::getHot() const {
+    return *hot;
 }
 
 
 void Process::executeCommand(int coreID) {
-    if (isFinished())
-        return;
+    executeBatch(coreID, 1);
+}
+
+// Runs up to maxCount instructions (a whole quantum, or until the process finishes)
+// under one lock acquisition and one state check
+ExecResult Process::executeBatch(int coreID, int maxCount) {
+    ProcessState state = getState();
+    if (state == FINISHED)
+        return { 0, true };
 
-    if (currentState == Process::WAITING)
-        return;
+    if (state == Process::WAITING)
+        return { 0, false };
 
-    this->coreID = coreID;
+    setCoreID(coreID);
     std::lock_guard<std::mutex> lock(processMutex);
 
-    if (currentState == RUNNING && commandCounter < linesOfCode) {
-        command->execute(coreID);
-        commandCounter++;
+    int executed = 0;
+    int counter = hot->commandCounter.load(std::memory_order_relaxed);
+    if (state == RUNNING && counter < hot->linesOfCode) {
+        executed = interpret(coreID, std::min(maxCount, hot->linesOfCode - counter));
+        counter += executed;
+        hot->commandCounter.store(counter, std::memory_order_relaxed);
     }
 
-    if (commandCounter >= linesOfCode) {
-        currentState = FINISHED;
+    if (counter >= hot->linesOfCode && transition(RUNNING, FINISHED)) {
         setEndTime();
     }
+    return { executed, isFinished() };
 }
 
-void Process::setStartTime() {
-    auto now = chrono::system_clock::now();
-    time_t currentTime = chrono::system_clock::to_time_t(now);
-    struct tm buf;
-    localtime_s(&buf, &currentTime);
+// Switch-dispatched loop over the contiguous program. Every opcode and every SLEEP tick counts as one
+// instruction; runs of the same opcode are logged as one record stamped with the batch's time.
+int Process::interpret(int coreID, int budget) {
+    static const VariableFile NO_VARIABLES;
+    const Instruction* code = program->code.data();
+    const int length = static_cast<int>(program->code.size());
+    const uint16_t* values = variables ? variables->values : NO_VARIABLES.values;
+    const int64_t now = static_cast<int64_t>(std::time(nullptr));
+    int executed = 0, run = 0;
+    Opcode runOp = Opcode::SLEEP;
 
-    char timeStr[100];
-    strftime(timeStr, sizeof(timeStr), "(%m/%d/%Y %I:%M:%S %p)", &buf);
+    while (executed < budget) {
+        if (sleepLeft > 0) {
+            int ticks = std::min(sleepLeft, budget - executed);
+            if (runOp != Opcode::SLEEP && run > 0) {
+                command.record(coreID, runOp, run, now);
+                run = 0;
+            }
+            runOp = Opcode::SLEEP;
+            run += ticks;
+            sleepLeft -= ticks;
+            executed += ticks;
+            continue;
+        }
+
+        const Instruction& instruction = code[pc++];
+        if (instruction.op != runOp) {
+            if (run > 0) {
+                command.record(coreID, runOp, run, now);
+            }
+            runOp = instruction.op;
+            run = 0;
+        }
+        run++;
+
+        switch (instruction.op) {
+        case Opcode::PRINT:     //the text is only made when the log is read
+            break;
+        case Opcode::DECLARE:
+            writableVariables()[instruction.dst] = instruction.value;
+            values = variables->values;
+            break;
+        case Opcode::ADD: {  //uint16 values clamp instead of wrapping
+            int operand = instruction.rhsIsVar ? values[instruction.rhs] : instruction.rhs;
+            int sum = std::min(values[instruction.lhs] + operand, 65535);
+            writableVariables()[instruction.dst] = static_cast<uint16_t>(sum);
+            values = variables->values;
+            break;
+        }
+        case Opcode::SUBTRACT: {
+            int operand = instruction.rhsIsVar ? values[instruction.rhs] : instruction.rhs;
+            int difference = std::max(values[instruction.lhs] - operand, 0);
+            writableVariables()[instruction.dst] = static_cast<uint16_t>(difference);
+            values = variables->values;
+            break;
+        }
+        case Opcode::SLEEP:
+            sleepLeft = instruction.value - 1;
+            break;
+        case Opcode::FOR:
+            loops[loopDepth++] = { pc, instruction.value };
+            break;
+        case Opcode::END:
+            if (--loops[loopDepth - 1].remaining > 0) {
+                pc = loops[loopDepth - 1].start;
+            }
+            else {
+                loopDepth--;
+            }
+            break;
+        }
+        executed++;
+        if (pc == length) {     //every FOR is closed by then, start the program over
+            pc = 0;
+        }
+    }
 
-    startTime = timeStr;
+    if (run > 0) {
+        command.record(coreID, runOp, run, now);
+    }
+    return executed;
 }
 
-void Process::setEndTime() {
-    auto now = chrono::system_clock::now();
-    time_t currentTime = chrono::system_clock::to_time_t(now);
+// Variable file for writing, copied off the shared all-zero one on the first write
+uint16_t* Process::writableVariables() {
+    if (!variables) {
+        variables = std::make_unique<VariableFile>();
+    }
+    return variables->values;
+}
+
+void Process::printLogs(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(processMutex);
+    command.print(out);
+}
+
+// Times are kept as time_points and only formatted when a screen or report shows them
+static std::string formatTime(std::chrono::system_clock::time_point time, const char* format) {
+    time_t currentTime = chrono::system_clock::to_time_t(time);
     struct tm buf;
     localtime_s(&buf, &currentTime);
 
     char timeStr[100];
-    strftime(timeStr, sizeof(timeStr), "(%m/%d/%Y %I:%M:%S %p)", &buf);
+    strftime(timeStr, sizeof(timeStr), format, &buf);
+    return timeStr;
+}
+
+std::string Process::formatStartTime(std::chrono::system_clock::time_point created) {
+    return formatTime(created, "%m/%d/%Y %I:%M:%S %p");
+}
 
-    endTime = timeStr;
+std::string Process::formatEndTime(std::chrono::system_clock::time_point ended) {
+    if (ended == std::chrono::system_clock::time_point{}) {
+        return "";
+    }
+    return formatTime(ended, "(%m/%d/%Y %I:%M:%S %p)");
+}
+
+void Process::setStartTime() {
+    hot->created = chrono::system_clock::now();
+}
+
+void Process::setEndTime() {
+    hot->ended = chrono::system_clock::now();
 }
 
 std::string Process::getStartTime() const {
-    return startTime;
+    return formatStartTime(hot->created);
 }
 
 std::string Process::getEndTime() const {
-    return endTime;
+    return formatEndTime(hot->ended);
 }
 
 int Process::getCoreID() const {
-    return coreID;
+    return hot->coreID.load(std::memory_order_relaxed);
 }
 
 int Process::getMemorySize() const {
     return memorySize;
 }
+
+int Process::getPriority() const {
+    return hot->priority;
+}
+
+void Process::setPriority(int priority) {
+    hot->priority = priority;
+}
+
+long long Process::getArrivalTick() const {
+    return hot->arrivalTick;
+}
+
+long long Process::getFinishTick() const {
+    return hot->finishTick;
+}
+
+long long Process::getRunTicks() const {
+    return hot->runTicks;
+}
+
+void Process::setArrivalTick(long long tick) {
+    hot->arrivalTick = tick;
+}
+
+void Process::setFinishTick(long long tick) {
+    hot->finishTick = tick;
+}
+
+void Process::addRunTicks(long long ticks) {
+    hot->runTicks += ticks;
+}
+
+int Process::getLastCoreID() const {
+    return hot->lastCoreID;
+}
+
+int Process::getMigrations() const {
+    return hot->migrations;
+}
+
+long long Process::getReadyTick() const {
+    return hot->readyTick;
+}
+
+void Process::setReadyTick(long long tick) {
+    hot->readyTick = tick;
+}
+
+// Puts the process on a core for its next slice and counts a migration if the core changed
+bool Process::assignCore(int coreID) {
+    bool migrated = hot->lastCoreID != -1 && hot->lastCoreID != coreID;
+    if (migrated) {
+        hot->migrations++;
+    }
+    hot->lastCoreID = coreID;
+    setCoreID(coreID);
+    return migrated;
+}
\ No newline at end of file
@@ -1,44 +1,79 @@
 #pragma once
 #include <string>
 #include <mutex>
+#include <memory>
 #include "PrintCommand.h"
+#include "Program.h"
+#include "ProcessTable.h"
 using namespace std;
 
+// Outcome of Process::executeBatch
+struct ExecResult {
+	int executed;	// instructions that ran
+	bool finished;
+};
+
 class Process {
 public:
 	enum ProcessState {
 		READY, RUNNING, WAITING, FINISHED
 	};
 
-	Process(int pid, const std::string& name, int lines, const std::string& startTime, int memory);
+	Process(int pid, const std::string& name, int lines, std::chrono::system_clock::time_point created, int memory, uint64_t programSeed);
+	~Process();
 	bool isFinished() const;
 	int getPID() const;
 	int getCommandCounter() const;
 	int getLinesOfCode() const;
 	int getCoreID() const;
 	int getMemorySize() const;
+	int getPriority() const;
+	int getLastCoreID() const;
+	int getMigrations() const;
+	long long getReadyTick() const;
+	long long getArrivalTick() const;
+	long long getFinishTick() const;
+	long long getRunTicks() const;
 	ProcessState getState() const;
 	std::string getName() const;
 	std::string getStartTime() const;
 	std::string getEndTime() const;
 
 	void setState(ProcessState newState);
+	bool transition(ProcessState from, ProcessState to);
 	void setStartTime();
 	void setEndTime();
 	void setCoreID(int coreID);
+	void setPriority(int priority);
+	void setReadyTick(long long tick);
+	bool assignCore(int coreID);
+	void setArrivalTick(long long tick);
+	void setFinishTick(long long tick);
+	void addRunTicks(long long ticks);
 	void executeCommand(int coreID);
+	ExecResult executeBatch(int coreID, int maxCount);
+	void printLogs(std::ostream& out) const;
+	const ProcessHot& getHot() const;
 	mutable std::mutex processMutex;
 
+	static std::string formatStartTime(std::chrono::system_clock::time_point created);
+	static std::string formatEndTime(std::chrono::system_clock::time_point ended);
+
 private:
-	int pid;
+	int interpret(int coreID, int budget);
+	uint16_t* writableVariables();
+
+	ProcessHot* hot;	// scheduling fields, in the dense ProcessTable
 	std::string name;
-	int commandCounter;
-	int coreID, memorySize;
+	int memorySize;
 
-	ProcessState currentState;
-	int linesOfCode = 0;
-	std::string startTime = "";
-	std::string endTime = "";
+	PrintCommand command;	// kept inline so a pooled Process is a single block
 
-	PrintCommand* command;
+	// shared program image and this process's interpreter state
+	std::shared_ptr<const Program> program;
+	int pc = 0;
+	int sleepLeft = 0;		// ticks left of the current SLEEP
+	int loopDepth = 0;
+	LoopFrame loops[Program::MAX_LOOP_DEPTH];
+	std::unique_ptr<VariableFile> variables;	// made on the first write, all zero until then
 };
@@ -0,0 +1,124 @@
+#include "ProcessTable.h"
+#include <algorithm>
+#include <new>
+#include "SlabPool.h"
+
+const size_t ProcessTable::SLOT_BATCH;     // passed to std::min by reference
+
+ProcessTable* ProcessTable::getInstance() {
+    static ProcessTable table;
+    return &table;
+}
+
+// Free slots of the calling thread; a finishing thread gives them back
+ProcessTable::SlotCache& ProcessTable::cache() {
+    thread_local SlotCache local;
+    return local;
+}
+
+ProcessTable::SlotCache::~SlotCache() {
+    if (!slots.empty()) {
+        ProcessTable::getInstance()->giveBack(slots, slots.size());
+    }
+}
+
+// The caller fills the slot in and then stores its state, which makes it visible to scans
+ProcessHot* ProcessTable::allocate() {
+    SlotCache& local = cache();
+    if (local.slots.empty()) {
+        refill(local);
+    }
+    ProcessHot* hot = local.slots.back();
+    local.slots.pop_back();
+    return hot;
+}
+
+// One copy of each name, shared by the slots and the finished records that carry it
+const std::string* ProcessTable::internName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    return &*names.insert(name).first;
+}
+
+void ProcessTable::release(ProcessHot* hot) {
+    hot->state.store(ProcessHot::FREE, std::memory_order_release);
+    SlotCache& local = cache();
+    local.slots.push_back(hot);
+    if (local.slots.size() >= 2 * SLOT_BATCH) {     //let other threads reuse the surplus
+        giveBack(local.slots, SLOT_BATCH);
+    }
+}
+
+// Takes a batch of freed slots, or SLOT_BATCH fresh ones from the last chunk
+void ProcessTable::refill(SlotCache& local) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    if (!freeSlots.empty()) {
+        size_t take = std::min(freeSlots.size(), SLOT_BATCH);
+        local.slots.insert(local.slots.end(), freeSlots.end() - take, freeSlots.end());
+        freeSlots.resize(freeSlots.size() - take);
+        return;
+    }
+    if (used == chunks.size() * CHUNK_SIZE) {
+        //operator new[] only aligns to 16 bytes before C++17, and the slots must not share cache lines
+        ProcessHot* chunk = static_cast<ProcessHot*>(allocateAligned(CHUNK_SIZE * sizeof(ProcessHot), alignof(ProcessHot)));
+        for (size_t i = 0; i < CHUNK_SIZE; i++) {
+            new (&chunk[i]) ProcessHot();
+        }
+        chunks.push_back(chunk);
+    }
+    for (size_t i = 0; i < SLOT_BATCH; i++) {   //CHUNK_SIZE is a multiple of SLOT_BATCH
+        local.slots.push_back(&chunks.back()[(used + SLOT_BATCH - 1 - i) % CHUNK_SIZE]);
+    }
+    used += SLOT_BATCH;
+}
+
+void ProcessTable::giveBack(std::vector<ProcessHot*>& slots, size_t count) {
+    std::lock_guard<std::mutex> lock(tableMutex);
+    freeSlots.insert(freeSlots.end(), slots.end() - count, slots.end());
+    slots.resize(slots.size() - count);
+}
+
+// Called once per finished process, before it is retired and its slot released
+void ProcessTable::recordFinished(const ProcessHot& hot) {
+    long long turnaround = hot.finishTick - hot.arrivalTick;
+    turnaroundSum.fetch_add(turnaround, std::memory_order_relaxed);
+    waitingSum.fetch_add(turnaround - hot.runTicks, std::memory_order_relaxed);
+    finishedCount.fetch_add(1, std::memory_order_relaxed);
+
+    FinishedProcess record;
+    record.name = hot.name;
+    record.coreID = hot.lastCoreID;
+    record.commandCounter = hot.commandCounter.load(std::memory_order_relaxed);
+    record.linesOfCode = hot.linesOfCode;
+    record.created = hot.created;
+    record.ended = hot.ended;
+
+    std::lock_guard<std::mutex> lock(historyMutex);
+    history.push_back(record);
+}
+
+std::vector<FinishedProcess> ProcessTable::getFinished() {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return history;
+}
+
+bool ProcessTable::wasFinished(const std::string& name) {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    for (const FinishedProcess& record : history) {
+        if (*record.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+long long ProcessTable::getFinishedCount() const {
+    return finishedCount.load(std::memory_order_relaxed);
+}
+
+long long ProcessTable::getTurnaroundSum() const {
+    return turnaroundSum.load(std::memory_order_relaxed);
+}
+
+long long ProcessTable::getWaitingSum() const {
+    return waitingSum.load(std::memory_order_relaxed);
+}
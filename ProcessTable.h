@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Scheduling data of one process, kept out of the Process object so the scans read dense memory.
+// The first cache line is what the dispatcher and the cores touch, the second what the reports read.
+struct alignas(64) ProcessHot {
+    static const int FREE = -1;     // state of an unused slot
+
+    std::atomic<int> state{ FREE };             // Process::ProcessState
+    std::atomic<int> commandCounter{ 0 };
+    std::atomic<int> coreID{ -1 };
+    int pid = 0;
+    int linesOfCode = 0;
+    int priority = 0;       // feedback level used by the MLFQ policy, 0 is highest
+    int lastCoreID = -1;    // core of the previous slice, kept when coreID is reset to -1
+    int migrations = 0;
+    long long readyTick = 0;    // scheduler clock when the process was last queued
+
+    alignas(64) long long arrivalTick = 0;     // fine clock of the scheduler, for turnaround statistics
+    long long finishTick = 0;
+    long long runTicks = 0;
+    std::chrono::system_clock::time_point created;
+    std::chrono::system_clock::time_point ended;    // zero until the process finishes
+    const std::string* name = nullptr;     // interned in the table, never freed
+};
+
+// What the reports keep of a retired process
+struct FinishedProcess {
+    const std::string* name;
+    int coreID;
+    int commandCounter;
+    int linesOfCode;
+    std::chrono::system_clock::time_point created;
+    std::chrono::system_clock::time_point ended;
+};
+
+// Dense storage for the ProcessHot of every live process, plus a compact record of every finished one.
+// Slots live in fixed chunks so their addresses never move. Each thread keeps its own free slots
+// and trades them with a shared list SLOT_BATCH at a time, so allocate and release rarely lock.
+class ProcessTable {
+public:
+    static ProcessTable* getInstance();
+
+    ProcessHot* allocate();
+    const std::string* internName(const std::string& name);
+    void release(ProcessHot* hot);
+
+    // Calls visit on every slot in use, in allocation order
+    template <typename Visit>
+    void forEach(Visit visit);
+
+    void recordFinished(const ProcessHot& hot);
+    std::vector<FinishedProcess> getFinished();     // oldest first
+    bool wasFinished(const std::string& name);
+    long long getFinishedCount() const;
+    long long getTurnaroundSum() const;
+    long long getWaitingSum() const;
+
+private:
+    static const size_t CHUNK_SIZE = 1024;
+    static const size_t SLOT_BATCH = 64;
+
+    struct SlotCache {
+        std::vector<ProcessHot*> slots;
+        ~SlotCache();
+    };
+    static SlotCache& cache();
+    void refill(SlotCache& local);
+    void giveBack(std::vector<ProcessHot*>& slots, size_t count);
+
+    std::mutex tableMutex;
+    std::vector<ProcessHot*> chunks;    // aligned, kept for the life of the program
+    size_t used = 0;                    // slots handed out so far, free or not
+    std::vector<ProcessHot*> freeSlots;
+
+    std::mutex namesMutex;
+    std::unordered_set<std::string> names;  // node based, so the pointers handed out stay valid
+
+    std::mutex historyMutex;
+    std::vector<FinishedProcess> history;   // in the order the processes finished
+    std::atomic<long long> finishedCount{ 0 };
+    std::atomic<long long> turnaroundSum{ 0 };
+    std::atomic<long long> waitingSum{ 0 };
+};
+
+template <typename Visit>
+void ProcessTable::forEach(Visit visit) {
+    std::vector<ProcessHot*> snapshot;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        for (ProcessHot* chunk : chunks) {
+            snapshot.push_back(chunk);
+        }
+        count = used;
+    }
+    for (size_t i = 0; i < count; i++) {
+        ProcessHot& hot = snapshot[i / CHUNK_SIZE][i % CHUNK_SIZE];
+        if (hot.state.load(std::memory_order_acquire) != ProcessHot::FREE) {
+            visit(hot);
+        }
+    }
+}
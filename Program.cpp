@@ -0,0 +1,85 @@
+#include "Program.h"
+#include "Random.h"
+
+const int Program::MAX_LENGTH;     // passed to std::min by reference
+#include <algorithm>
+
+// Appends up to room instructions; FOR bodies are generated recursively up to MAX_LOOP_DEPTH
+static void generateBlock(Random& random, std::vector<Instruction>& code, int room, int depth) {
+    while (room > 0) {
+        Instruction instruction{};
+        int pick = random.between(0, 99);
+        if (pick < 12 && depth < Program::MAX_LOOP_DEPTH && room >= 3) {
+            int body = random.between(1, std::min(room - 2, 6));
+            instruction.op = Opcode::FOR;
+            instruction.value = static_cast<uint16_t>(random.between(2, 4));
+            code.push_back(instruction);
+            generateBlock(random, code, body, depth + 1);
+            Instruction end{};
+            end.op = Opcode::END;
+            code.push_back(end);
+            room -= body + 2;
+            continue;
+        }
+
+        instruction.dst = static_cast<uint8_t>(random.between(0, Program::VARIABLE_COUNT - 1));
+        instruction.lhs = static_cast<uint8_t>(random.between(0, Program::VARIABLE_COUNT - 1));
+        instruction.rhsIsVar = static_cast<uint8_t>(random.between(0, 1));
+        instruction.rhs = static_cast<uint16_t>(instruction.rhsIsVar ? random.between(0, Program::VARIABLE_COUNT - 1) : random.between(1, 100));
+        if (pick < 45) {
+            instruction.op = Opcode::PRINT;
+        }
+        else if (pick < 65) {
+            instruction.op = Opcode::DECLARE;
+            instruction.value = static_cast<uint16_t>(random.between(0, 1000));
+        }
+        else if (pick < 80) {
+            instruction.op = Opcode::ADD;
+        }
+        else if (pick < 95) {
+            instruction.op = Opcode::SUBTRACT;
+        }
+        else {
+            instruction.op = Opcode::SLEEP;
+            instruction.value = static_cast<uint16_t>(random.between(1, 4));
+        }
+        code.push_back(instruction);
+        room--;
+    }
+}
+
+// Interned images by (variant, length), all made on first use. The table is read-only afterwards,
+// so interning takes no lock.
+static const std::vector<std::shared_ptr<const Program>>& images() {
+    static const std::vector<std::shared_ptr<const Program>> table = []() {
+        std::vector<std::shared_ptr<const Program>> made;
+        for (int key = 0; key < (Program::MAX_LENGTH + 1) * Program::VARIANTS; key++) {
+            int length = std::max(1, key / Program::VARIANTS);
+            made.push_back(std::make_shared<const Program>(Program::generate(static_cast<uint64_t>(key), length)));
+        }
+        return made;
+    }();
+    return table;
+}
+
+std::shared_ptr<const Program> Program::intern(uint64_t seed, int lines) {
+    int variant = static_cast<int>(seed % VARIANTS);
+    int length = std::max(1, std::min(lines, MAX_LENGTH));
+    return images()[length * VARIANTS + variant];
+}
+
+int Program::internedCount() {
+    int used = 0;
+    for (const auto& image : images()) {
+        used += image.use_count() > 1 ? 1 : 0;
+    }
+    return used;
+}
+
+Program Program::generate(uint64_t seed, int length) {
+    Random random(seed);
+    Program program;
+    program.code.reserve(length);
+    generateBlock(random, program.code, length, 0);
+    return program;
+}
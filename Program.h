@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <memory>
+
+// Opcodes of the process bytecode. FOR repeats the instructions up to its matching END.
+enum class Opcode : uint8_t {
+    PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR, END
+};
+
+// One 8-byte bytecode instruction. Which fields are used depends on the opcode:
+// DECLARE dst = value; ADD/SUBTRACT dst = lhs op (rhsIsVar ? var[rhs] : rhs); SLEEP value ticks; FOR value times
+struct Instruction {
+    Opcode op;
+    uint8_t dst;
+    uint8_t lhs;
+    uint8_t rhsIsVar;
+    uint16_t rhs;
+    uint16_t value;
+};
+
+// Open FOR of a running process: first body instruction and passes left
+struct LoopFrame {
+    int start;
+    int remaining;
+};
+
+// Program image, a contiguous array of instructions. A process runs it from the top again when it
+// reaches the end, until it has executed its number of instructions. Images are immutable and
+// interned: processes with the same variant and length share one image.
+class Program {
+public:
+    static const int MAX_LENGTH = 32;       // longer processes loop over their program
+    static const int MAX_LOOP_DEPTH = 3;
+    static const int VARIABLE_COUNT = 16;
+    static const int VARIANTS = 8;          // distinct programs per length
+
+    static std::shared_ptr<const Program> intern(uint64_t seed, int lines);
+    static int internedCount();             // images some process is running
+
+    std::vector<Instruction> code;
+
+    static Program generate(uint64_t seed, int length);
+};
+
+// Variables of a running program, uint16 like the instruction operands
+struct VariableFile {
+    uint16_t values[Program::VARIABLE_COUNT] = {};
+};
@@ -0,0 +1,8 @@
+#include "RRPolicy.h"
+#include <algorithm>
+
+RRPolicy::RRPolicy(int quantum) : quantum(std::max(quantum, 1)) {}
+
+int RRPolicy::timeSlice(const std::shared_ptr<Process>& /*process*/) const {
+    return quantum;
+}
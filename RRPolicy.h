@@ -0,0 +1,12 @@
+#pragma once
+#include "FCFSPolicy.h"
+
+// Same FIFO queue as FCFS but every process is preempted after quantum-cycles instructions
+class RRPolicy : public FCFSPolicy {
+public:
+    RRPolicy(int quantum);
+    int timeSlice(const std::shared_ptr<Process>& process) const override;
+
+private:
+    int quantum;
+};
@@ -0,0 +1,23 @@
+#include "Random.h"
+
+Random::Random(uint64_t seed) : state(mix(seed)) {}
+
+uint64_t Random::next() {
+    state += 0x9E3779B97F4A7C15ULL;
+    return mix(state);
+}
+
+// Multiply-shift instead of modulo; the bias is below 2^-32 for the ranges used here
+int Random::between(int min, int max) {
+    if (max <= min) {
+        return min;
+    }
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<int64_t>(((next() >> 32) * range) >> 32));
+}
+
+uint64_t Random::mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+// Small fast generator (splitmix64) for workload generation. Seeding is a single store,
+// unlike std::random_device + std::mt19937, so an engine can live per thread and be cheap to make.
+class Random {
+public:
+    explicit Random(uint64_t seed);
+
+    uint64_t next();
+    int between(int min, int max);  // uniform in [min, max]
+
+    static uint64_t mix(uint64_t value);    // scrambles a seed so nearby seeds give unrelated streams
+
+private:
+    uint64_t state;
+};
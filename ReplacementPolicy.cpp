@@ -0,0 +1,40 @@
+#include "ReplacementPolicy.h"
+#include "FIFOReplacement.h"
+#include "LRUReplacement.h"
+#include "ClockReplacement.h"
+#include "WorkingSetReplacement.h"
+#include <algorithm>
+
+// Picks the policy named by the "page-replacement" key of config.txt, FIFO by default. A working-set
+// window of 0 defaults to one reference per frame.
+std::unique_ptr<ReplacementPolicy> ReplacementPolicy::create(const std::string& type, int frames, int window) {
+    if (type == "lru") {
+        return std::make_unique<LRUReplacement>(frames);
+    }
+    if (type == "clock") {
+        return std::make_unique<ClockReplacement>(frames);
+    }
+    if (type == "ws") {
+        return std::make_unique<WorkingSetReplacement>(frames, window > 0 ? window : std::max(frames, 1));
+    }
+    return std::make_unique<FIFOReplacement>(frames);
+}
+
+FrameList::FrameList(int frames) : prev(frames, -1), next(frames, -1) {}
+
+void FrameList::pushBack(int frame) {
+    prev[frame] = tail;
+    next[frame] = -1;
+    (tail >= 0 ? next[tail] : head) = frame;
+    tail = frame;
+}
+
+void FrameList::remove(int frame) {
+    (prev[frame] >= 0 ? next[prev[frame]] : head) = next[frame];
+    (next[frame] >= 0 ? prev[next[frame]] : tail) = prev[frame];
+    prev[frame] = next[frame] = -1;
+}
+
+int FrameList::front() const {
+    return head;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+// Page replacement policy of paging mode. It tracks the loaded frames and picks the one whose page
+// is written out when a fault finds no free frame. Called under the memory manager's lock.
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+
+    virtual void onLoad(int frame) = 0;     // a faulting page was loaded into the frame
+    virtual void onTouch(int /*frame*/) {}  // the frame's page was referenced again
+    virtual void onFree(int frame) = 0;     // the frame was freed, its process finished
+    virtual int victim() = 0;               // frame to replace, stops tracking it; memory is full
+    virtual int expired() { return -1; }    // loaded frame the policy gives up without a fault, -1 if none
+    virtual std::string getName() const = 0;
+
+    static std::unique_ptr<ReplacementPolicy> create(const std::string& type, int frames, int window);
+};
+
+// Doubly linked list over frame numbers, kept in arrays so every operation is O(1)
+class FrameList {
+public:
+    explicit FrameList(int frames);
+    void pushBack(int frame);
+    void remove(int frame);
+    int front() const;      // -1 if empty
+
+private:
+    std::vector<int> prev;
+    std::vector<int> next;
+    int head = -1;
+    int tail = -1;
+};
@@ -0,0 +1,79 @@
+#include "SJFPolicy.h"
+#include <algorithm>
+
+SJFPolicy::SJFPolicy(int quantum) : quantum(std::max(quantum, 0)) {}
+
+// Keyed on the instructions left when the process is queued; a preempted process is queued again
+// with its new count, so the key of a waiting process never goes stale
+void SJFPolicy::push(std::shared_ptr<Process> process) {
+    long long remaining = process->getLinesOfCode() - process->getCommandCounter();
+    heap.push_back({ remaining, nextSeq++, process });
+    siftUp(heap.size() - 1);
+}
+
+std::shared_ptr<Process> SJFPolicy::pop() {
+    if (heap.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<Process> process = heap.front().process;
+    std::swap(heap.front(), heap.back());
+    heap.pop_back();
+    if (!heap.empty()) {
+        siftDown(0);
+    }
+    return process;
+}
+
+// Idle peers also get the shortest job, which keeps the order close to a global SJF
+std::shared_ptr<Process> SJFPolicy::steal() {
+    return pop();
+}
+
+std::shared_ptr<Process> SJFPolicy::stealCandidate() const {
+    return heap.empty() ? nullptr : heap.front().process;
+}
+
+size_t SJFPolicy::size() const {
+    return heap.size();
+}
+
+int SJFPolicy::timeSlice(const std::shared_ptr<Process>& /*process*/) const {
+    return quantum;
+}
+
+bool SJFPolicy::less(size_t a, size_t b) const {
+    if (heap[a].remaining != heap[b].remaining) {
+        return heap[a].remaining < heap[b].remaining;
+    }
+    return heap[a].seq < heap[b].seq;
+}
+
+void SJFPolicy::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!less(index, parent)) {
+            break;
+        }
+        std::swap(heap[index], heap[parent]);
+        index = parent;
+    }
+}
+
+void SJFPolicy::siftDown(size_t index) {
+    while (true) {
+        size_t left = 2 * index + 1;
+        size_t right = left + 1;
+        size_t smallest = index;
+        if (left < heap.size() && less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < heap.size() && less(right, smallest)) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        std::swap(heap[index], heap[smallest]);
+        index = smallest;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "SchedulingPolicy.h"
+#include <vector>
+
+// Shortest job first on a binary min-heap keyed on remaining instructions (ties in arrival order).
+// With a quantum it becomes shortest remaining time first: the running process is preempted after
+// every quantum and re-keyed, so a shorter arrival takes the core at the next slice boundary.
+class SJFPolicy : public SchedulingPolicy {
+public:
+    SJFPolicy(int quantum);     // 0 for non-preemptive SJF
+    void push(std::shared_ptr<Process> process) override;
+    std::shared_ptr<Process> pop() override;
+    std::shared_ptr<Process> steal() override;
+    std::shared_ptr<Process> stealCandidate() const override;
+    size_t size() const override;
+    int timeSlice(const std::shared_ptr<Process>& process) const override;
+
+private:
+    struct Entry {
+        long long remaining;
+        long long seq;
+        std::shared_ptr<Process> process;
+    };
+
+    bool less(size_t a, size_t b) const;
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+
+    int quantum;
+    long long nextSeq = 0;
+    std::vector<Entry> heap;
+};
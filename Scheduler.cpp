@@ -2,6 +2,7 @@
 #include "Scheduler.h"
 #include "Process.h"
 #include "MemoryManager.h"
+#include "LogWriter.h"
 #include <fstream>
 #include <iostream>
 #include <ctime>
@@ -10,47 +11,196 @@
 #include <mutex>
 #include <memory>  
 #include <random>
+#include <cstdio>
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 using namespace std;
 
-Scheduler::Scheduler(int numCores, const std::string& type, int timeSlice, int freq, int min, int max, int delay, int memMax, int memFrame, int minMemProc, int maxMemProc) :
-    numCores(numCores), type(type), coreAvailable(numCores, true), workers(numCores),
-    timeSlice(timeSlice), batchFreq(freq), minIns(min), maxIns(max), delaysPerExec(delay),
+const int Scheduler::GENERATOR_PERIOD_MS;     // passed to std::max by reference
+
+// Pins the calling thread to one of the host CPUs the process may run on: the index-th allowed one,
+// wrapping around. On Windows the allowed CPUs may span several processor groups.
+static bool pinCurrentThread(int index) {
+#ifdef _WIN32
+    USHORT groups[64];
+    USHORT groupCount = 64;
+    DWORD_PTR processMask, systemMask;
+    if (!GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, groups)
+        || !GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        return false;
+    }
+    std::vector<GROUP_AFFINITY> allowed;
+    for (USHORT i = 0; i < groupCount; i++) {
+        DWORD count = std::min<DWORD>(GetActiveProcessorCount(groups[i]), sizeof(KAFFINITY) * 8);
+        for (DWORD bit = 0; bit < count; bit++) {
+            KAFFINITY cpu = KAFFINITY(1) << bit;
+            if (groupCount == 1 && (processMask & cpu) == 0) {  //the mask only describes a single group
+                continue;
+            }
+            GROUP_AFFINITY affinity = {};
+            affinity.Group = groups[i];
+            affinity.Mask = cpu;
+            allowed.push_back(affinity);
+        }
+    }
+    if (allowed.empty()) {
+        return false;
+    }
+    return SetThreadGroupAffinity(GetCurrentThread(), &allowed[index % allowed.size()], nullptr) != 0;
+#else
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return false;
+    }
+    int wanted = index % CPU_COUNT(&allowed);
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && wanted-- == 0) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(cpu, &cpuSet);
+            return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+        }
+    }
+    return false;
+#endif
+}
+
+Scheduler::Scheduler(int numCores, const std::string& type, int timeSlice, int freq, int min, int max, int delay, int memMax, int memFrame, int minMemProc, int maxMemProc, bool virtualClock, bool pinCores, uint64_t seed, const std::string& pageReplacement, int workingSetWindow) :
+    memoryManager(memMax, memFrame, memMax, pageReplacement, workingSetWindow),
+    seed(seed != 0 ? seed : std::random_device{}()),
+    runQueues(numCores), workers(numCores), coreSlots(numCores), pinCores(pinCores),
+    type(type), coreAvailable(numCores), numCores(numCores),
+    timeSlice(timeSlice), minIns(min), maxIns(max), batchFreq(freq), delaysPerExec(delay),
     maxOverallMem(memMax), memPerFrame(memFrame), minMemPerProc(minMemProc), maxMemPerProc(maxMemProc),
-    memoryManager(memMax, memFrame, memMax), activeTicks(0), idleTicks(0) {}
+    coreTicks(numCores), virtualClock(virtualClock), simCores(numCores) {
+    for (auto& available : coreAvailable) {
+        available = true;
+    }
+    for (auto& runQueue : runQueues) {
+        runQueue.policy = SchedulingPolicy::create(type, timeSlice);
+    }
+    memoryManager.setWakeCallback([this](std::shared_ptr<Process> process) {
+        {
+            std::lock_guard<std::mutex> lock(wokenMutex);
+            memoryWoken.push_back(process);
+        }
+        wokenCount++;
+        postWork(1);
+    });
+}
 
 void Scheduler::addProcess(std::shared_ptr<Process> process) {  
-    process->setState(Process::READY); //set to READY first
-    processes.push_back(process);
-    processQueue.push(process);
-    cv.notify_all();
+    addProcesses({ process });
+}
+
+// Publishes a batch of new processes with one CAS on the arrival stack. The reports find them
+// through the ProcessTable, so the scheduler keeps no list of its own.
+void Scheduler::addProcesses(const std::vector<std::shared_ptr<Process>>& batch) {
+    long long now = fineClockNow();
+    for (auto& process : batch) {
+        process->setState(Process::READY); //set to READY first
+        process->setArrivalTick(now);
+    }
+    pushArrivals(batch);
+    postWork(static_cast<int>(batch.size()));
 }
 
 void Scheduler::startScheduling() {
     std::lock_guard<std::mutex> lock(queueMutex);
-    if (delaysPerExec >= 0 && delaysPerExec < 50) delaysPerExec = 50;
     stop = false;
-    if (!schedulerThread.joinable()) {
-        schedulerThread = std::thread(&Scheduler::schedule, this);
+    if (virtualClock) { //delay is counted in simulated cycles so nothing to clamp and no core threads
+        if (!schedulerThread.joinable()) {
+            schedulerThread = std::thread(&Scheduler::simulate, this);
+        }
+        return;
+    }
+    if (delaysPerExec > 0 && delaysPerExec < 50) delaysPerExec = 50;   //0 keeps running whole slices as one batch,
+                                                                        //the generator keeps its own minimum period
+    for (int coreId = 0; coreId < numCores; ++coreId) {    //each core picks its own work, there is no dispatcher thread
+        if (!workers[coreId].joinable()) {
+            workers[coreId] = std::thread(&Scheduler::coreLoop, this, coreId);
+        }
     }
 }
 
 void Scheduler::generateProcesses() {
+    if (virtualClock) { //the simulation loop generates on its own clock
+        generating = true;
+        wakeScheduler();
+        return;
+    }
     if (!generateProcessThread.joinable()) {
         generateProcessThread = std::thread([this]() {
+            useRandomStream(GENERATOR_STREAM);
             while (!stop) {
-                for (int i = 0; i < batchFreq; i++) {
-                    generateProcess();
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(delaysPerExec));
+                generateBatch(batchFreq);
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::max(delaysPerExec, GENERATOR_PERIOD_MS)));
             }
         });
     }
 }
 
-void Scheduler::startTicksProcesses() {
-    if (!ticksThread.joinable()) {
-        ticksThread = std::thread(&Scheduler::startTicks, this);
+// Starts streaming a trace's arrivals into the scheduler. Returns the number of arrivals,
+// or -1 with the reason in error when the file cannot be used.
+long long Scheduler::replayTrace(const std::string& path, std::string& error) {
+    if (stop) {     //the replay would end before its first arrival
+        error = "the scheduler has been stopped";
+        return -1;
+    }
+    if (replaying) {
+        error = "a trace is already being replayed";
+        return -1;
+    }
+    if (replayThread.joinable()) {
+        replayThread.join();
+    }
+    auto loaded = std::make_unique<Trace>();
+    if (!loaded->open(path, error)) {
+        return -1;
+    }
+    trace = std::move(loaded);
+    traceNext = 0;
+    if (trace->size() == 0) {
+        return 0;
+    }
+    replayStart = clockNow();
+    replaying = true;
+
+    if (virtualClock) { //the simulation loop replays on its own clock
+        wakeScheduler();
+        return static_cast<long long>(trace->size());
+    }
+    replayThread = std::thread([this]() {
+        useRandomStream(REPLAY_STREAM);
+        while (!stop && traceNext < trace->size()) {
+            long long now = clockNow() - replayStart;
+            replayDue(now);
+            if (traceNext < trace->size()) {    //sleep until the next arrival, but wake often enough to see a stop
+                long long wait = static_cast<long long>((*trace)[traceNext].arrival) - now;
+                std::this_thread::sleep_for(std::chrono::milliseconds(std::min(std::max(wait, 1LL), 50LL)));
+            }
+        }
+        replaying = false;
+    });
+    return static_cast<long long>(trace->size());
+}
+
+// Creates every trace arrival due by now, in batches so a burst still costs one publish per batch.
+// Sizes outside the configured range are clamped so every process can be placed.
+void Scheduler::replayDue(long long now) {
+    const size_t REPLAY_BATCH = 4096;
+    const Trace& records = *trace;
+    while (traceNext < records.size() && static_cast<long long>(records[traceNext].arrival) <= now) {
+        std::vector<ProcessSpec> specs;
+        while (traceNext < records.size() && static_cast<long long>(records[traceNext].arrival) <= now && specs.size() < REPLAY_BATCH) {
+            const TraceRecord& record = records[traceNext++];
+            int memory = record.memory != 0 ? static_cast<int>(record.memory) : generateMemory();
+            specs.push_back({ std::max(static_cast<int>(record.instructions), 1), std::min(std::max(memory, minMemPerProc), maxMemPerProc), generateProgramSeed() });
+        }
+        ConsoleManager::getInstance()->createProcessBatch(specs);
     }
 }
 
@@ -61,173 +211,452 @@ void Scheduler::stopScheduler() {
     if (generateProcessThread.joinable()) {
         generateProcessThread.join();
     }
+    if (replayThread.joinable()) {
+        replayThread.join();
+    }
     cv.notify_all();
 }
 
-void Scheduler::schedule() {
-    while (true) {
-        if (type == "fcfs") {
-            scheduleFCFS();
-        }
-        else if (type == "rr") {
-            scheduleRR();
+// Stops generation, then ends and joins the core threads and the simulation thread. A core cuts its
+// current slice short and requeues the process. Called on exit, before the console and the log writer
+// the cores report to are destroyed.
+void Scheduler::shutdown() {
+    stopScheduler();
+    shuttingDown = true;
+    for (auto& slot : coreSlots) {
+        std::lock_guard<std::mutex> lock(slot.slotMutex);
+        slot.parked.store(false);
+        slot.slotCv.notify_all();
+    }
+    wakeScheduler();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
         }
-        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    if (schedulerThread.joinable()) {
+        schedulerThread.join();
     }
 }
 
-void Scheduler::generateProcess() {
-    int random = generateRandomNumber(minIns, maxIns);
-    int processMemory = generateMemory();
-    int lastPID = ConsoleManager::getInstance()->getCurrentPID() + 1;
-    string initialName = "P";
-    string newName = initialName + to_string(lastPID);
-    ConsoleManager::getInstance()->createProcess(newName, random, processMemory);
+// Draws a whole batch of dummy processes and creates them in one call
+void Scheduler::generateBatch(int count) {
+    std::vector<ProcessSpec> specs(std::max(count, 0));
+    for (auto& spec : specs) {
+        spec.lines = generateInstructions();
+        spec.memory = generateMemory();
+        spec.programSeed = generateProgramSeed();
+    }
+    ConsoleManager::getInstance()->createProcessBatch(specs);
 }
 
-void Scheduler::scheduleFCFS() {
-    std::unique_lock<std::mutex> lock(queueMutex);
-    while (true) {
-
-        cv.wait(lock, [this] {
-            return !processQueue.empty(); // Wait until a process is available in the queue
-            });
-
-        std::shared_ptr<Process> process = processQueue.front();
-        bool assigned = false;
-
-        // Assign process to an available core but check first if it has available memory or already in memory
-        for (int coreId = 0; coreId < numCores; ++coreId) {
-            if (coreAvailable[coreId]) {                                //check if allocated
-                if (!memoryManager.isAllocated(process->getPID())) {    //check if it can be allocated
-                    if (!memoryManager.allocate(process)) {
-                        //cannot be allocated
-                        continue;
-                    }  
-                }
-                coreAvailable[coreId] = false;
-                assigned = true;
-                processQueue.pop();
-
-                if (workers[coreId].joinable()) {
-                    workers[coreId].join();
-                }
-
-                workers[coreId] = std::thread(&Scheduler::worker, this, coreId, process);
-                break;
+// One dispatch pass over the free cores of the simulation
+void Scheduler::fillFreeCores() {
+    affinityRetryAt = -1;
+    for (int coreId = 0; coreId < numCores; ++coreId) {
+        if (coreAvailable[coreId]) {
+            std::shared_ptr<Process> process = takeWoken();
+            if (process == nullptr) {
+                process = takeReady(coreId, affinityRetryAt);
             }
+            if (process == nullptr || !admit(process)) {
+                continue;   //nothing this core may take yet
+            }
+            coreAvailable[coreId] = false;
+            markCoreBusy(coreId);
+            startSlice(coreId, process);
         }
+    }
+}
 
-        if (!assigned) { //no memory or core so go back
-            processQueue.pop();
-            processQueue.push(process);
-            cv.wait(lock, [this] {
-                return std::any_of(coreAvailable.begin(), coreAvailable.end(), [](bool available) { return available; });
-                });
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+// Checks that a picked process has its memory: still resident, or allocated now. Otherwise it is parked
+// in the memory-wait list until enough memory is released.
+bool Scheduler::admit(const std::shared_ptr<Process>& process) {
+    if (memoryManager.isAllocated(process->getPID())) {    //still resident, so it must not be evicted while it runs
+        memoryManager.setStatus(process->getPID(), Residency::RUNNING);
+        return true;
     }
+    return memoryManager.allocateOrWait(process);
+}
 
-    lock.unlock();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+// Processes woken from the memory-wait list go first, they were at the head of a queue when they blocked
+std::shared_ptr<Process> Scheduler::takeWoken() {
+    if (wokenCount.load(std::memory_order_acquire) == 0) {  //usually empty, so skip the lock
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(wokenMutex);
+    if (memoryWoken.empty()) {
+        return nullptr;
+    }
+    std::shared_ptr<Process> process = memoryWoken.front();
+    memoryWoken.pop_front();
+    wokenCount--;
+    return process;
 }
 
-void Scheduler::scheduleRR() {
-    std::unique_lock<std::mutex> lock(queueMutex);
-    while (true) {
+// Lock-free push of a whole batch onto the arrival stack: the batch is linked newest first
+// and spliced in with one CAS, so producers never contend with the dispatcher
+void Scheduler::pushArrivals(const std::vector<std::shared_ptr<Process>>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+    ArrivalNode* oldest = new ArrivalNode{ batch.front(), nullptr };
+    ArrivalNode* newest = oldest;
+    for (size_t i = 1; i < batch.size(); i++) {
+        newest = new ArrivalNode{ batch[i], newest };
+    }
+    oldest->next = arrivals.load(std::memory_order_relaxed);
+    while (!arrivals.compare_exchange_weak(oldest->next, newest, std::memory_order_release, std::memory_order_relaxed)) {}
+}
 
-        cv.wait(lock, [this] {
-            return !processQueue.empty(); // Wait until a process is available in the queue
-            });
-
-        std::shared_ptr<Process> process = processQueue.front();
-        bool assigned = false;
-
-        // Assign process to an available core but check first if it has available memory or already in memory
-        for (int coreId = 0; coreId < numCores; ++coreId) {
-            if (coreAvailable[coreId]) {                                //check if allocated
-                if (!memoryManager.isAllocated(process->getPID())) {    //check if it can be allocated
-                    if (!memoryManager.allocate(process)) {
-                        //cannot be allocated
-                        continue;
-                    }  
-                }
-                coreAvailable[coreId] = false;
-                assigned = true;
-                processQueue.pop();
-
-                if (workers[coreId].joinable()) {
-                    workers[coreId].join();
-                }
-
-                workers[coreId] = std::thread(&Scheduler::workerRR, this, coreId, process);
-                break;
-            }
+// Moves every pending arrival, oldest first, onto the tail of one core's run queue, so arrivals
+// keep their order and thieves take the oldest of them first
+void Scheduler::drainArrivals(int coreId) {
+    if (arrivals.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    ArrivalNode* node = arrivals.exchange(nullptr, std::memory_order_acquire);
+    ArrivalNode* oldest = nullptr;
+    while (node != nullptr) {   //stack is newest first so reverse it
+        ArrivalNode* next = node->next;
+        node->next = oldest;
+        oldest = node;
+        node = next;
+    }
+
+    RunQueue& runQueue = runQueues[coreId];
+    long long now = clockNow();
+    std::lock_guard<std::mutex> lock(runQueue.runMutex);
+    while (oldest != nullptr) {
+        ArrivalNode* next = oldest->next;
+        oldest->process->setReadyTick(now);
+        runQueue.policy->push(oldest->process);
+        delete oldest;
+        oldest = next;
+    }
+}
+
+void Scheduler::enqueueReady(int coreId, std::shared_ptr<Process> process) {
+    RunQueue& runQueue = runQueues[coreId];
+    std::lock_guard<std::mutex> lock(runQueue.runMutex);
+    process->setReadyTick(clockNow());
+    runQueue.policy->push(process);
+}
+
+// Next process for a core. Pending arrivals are first appended to its own queue. A core that had
+// nothing queued steals from the longest peer queue before it runs the new arrivals, so they do not
+// overtake processes already waiting elsewhere; otherwise it asks its own policy. A process held for
+// its last core sets retryAt to when it may migrate.
+std::shared_ptr<Process> Scheduler::takeReady(int coreId, long long& retryAt) {
+    RunQueue& own = runQueues[coreId];
+    bool hadOwn;
+    {
+        std::lock_guard<std::mutex> lock(own.runMutex);
+        hadOwn = own.policy->size() > 0;
+    }
+    drainArrivals(coreId);
+    if (!hadOwn) {
+        std::shared_ptr<Process> stolen = steal(coreId, retryAt);
+        if (stolen != nullptr) {
+            return stolen;
+        }
+    }
+    std::lock_guard<std::mutex> lock(own.runMutex);
+    return own.policy->pop();
+}
+
+// Takes the steal candidate of the longest peer queue, unless it is still held for another core
+std::shared_ptr<Process> Scheduler::steal(int coreId, long long& retryAt) {
+
+    int victim = -1;
+    size_t longest = 0;
+    for (int i = 1; i < numCores; ++i) {
+        int peer = (coreId + i) % numCores;
+        std::lock_guard<std::mutex> lock(runQueues[peer].runMutex);
+        if (runQueues[peer].policy->size() > longest) {
+            longest = runQueues[peer].policy->size();
+            victim = peer;
         }
+    }
+    if (victim == -1) {
+        return nullptr;
+    }
 
-        if (!assigned) { //no memory or core so go back
-            processQueue.pop();
-            processQueue.push(process);
-            cv.wait(lock, [this] {
-                return std::any_of(coreAvailable.begin(), coreAvailable.end(), [](bool available) { return available; });
-                });
+    RunQueue& peer = runQueues[victim];
+    std::lock_guard<std::mutex> lock(peer.runMutex);
+    std::shared_ptr<Process> candidate = peer.policy->stealCandidate();
+    if (candidate == nullptr) {
+        return nullptr;
+    }
+    if (candidate->getLastCoreID() != -1 && candidate->getLastCoreID() != coreId) {
+        // Still warm in another core's cache: hold it there for a bounded time before migrating it
+        long long allowedAt = candidate->getReadyTick() + affinityHold();
+        if (clockNow() < allowedAt) {
+            if (retryAt < 0 || allowedAt < retryAt) {
+                retryAt = allowedAt;
+            }
+            return nullptr;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    return peer.policy->steal();
+}
 
-    lock.unlock();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+// Posts a dispatch event to the simulation loop: a core freed up, a process arrived or memory was released
+void Scheduler::wakeScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        dispatchPending = true;
+    }
+    cv.notify_all();
 }
 
-// Worker function specific to RR scheduling
-void Scheduler::workerRR(int coreId, std::shared_ptr<Process> process) {
-    if (process == nullptr) {
+// Announces count newly ready processes: to the simulation loop, or to up to count parked core threads
+void Scheduler::postWork(int count) {
+    if (virtualClock) {
+        wakeScheduler();
         return;
     }
-    if (process != nullptr && !process->getName().empty()) {
-        process->setState(Process::RUNNING);
-        process->setCoreID(coreId);
-        int ctr = 0;
-        
-        // Execute process within the time slice for RR
-        while (ctr < timeSlice && !process->isFinished()) {
-            process->executeCommand(coreId);
-            ctr++;
-            incrementTicks(1);
-            std::this_thread::sleep_for(chrono::milliseconds(delaysPerExec));
+    workEpoch.fetch_add(1);
+    for (int coreId = 0; coreId < numCores && count > 0; ++coreId) {
+        CoreSlot& slot = coreSlots[coreId];
+        if (slot.parked.load() && slot.parked.exchange(false)) {   //only a parked core costs a lock
+            std::lock_guard<std::mutex> lock(slot.slotMutex);
+            slot.slotCv.notify_one();
+            count--;
         }
-        memoryManager.setStatus(process->getPID(), "idle");
-        coreAvailable[coreId] = true;   //set to true now since done
+    }
+}
+
+// Sleeps an idle core until work is posted after it last looked (epoch), or until a held process may migrate.
+// parked is set before the epoch is checked again, and postWork bumps the epoch before it reads parked,
+// so a post is never missed.
+void Scheduler::parkCore(int coreId, long long epoch, long long retryAt) {
+    CoreSlot& slot = coreSlots[coreId];
+    std::unique_lock<std::mutex> lock(slot.slotMutex);
+    slot.parked.store(true);
+    if (workEpoch.load() != epoch) {
+        slot.parked.store(false);
+        return;
+    }
+    auto woken = [this, &slot] { return !slot.parked.load() || shuttingDown; };
+    if (retryAt < 0) {
+        slot.slotCv.wait(lock, woken);
+    }
+    else {
+        long long holdLeft = std::max(0LL, retryAt - clockNow());
+        slot.slotCv.wait_for(lock, chrono::milliseconds(holdLeft), woken);
+    }
+    slot.parked.store(false);
+}
 
-        if (!process->isFinished()) {
-            process->setState(Process::WAITING);
-            process->setCoreID(-1);
-            processQueue.push(process);
+// Body of a persistent emulated core: takes its next process from its own run queue, or steals one,
+// and runs it; parks when there is nothing it may take
+void Scheduler::coreLoop(int coreId) {
+    if (pinCores) {
+        placeCore(coreId);
+    }
+    while (!shuttingDown) {
+        long long epoch = workEpoch.load();
+        long long retryAt = -1;
+        std::shared_ptr<Process> process = takeWoken();
+        if (process == nullptr) {
+            process = takeReady(coreId, retryAt);
+        }
+        if (process == nullptr) {
+            parkCore(coreId, epoch, retryAt);
+            continue;
         }
-        else {
-            memoryManager.deallocateMemory(process->getPID());
+        if (!admit(process)) {
+            continue;   //waits for memory, the release posts it again
         }
-        cv.notify_all(); // Notify scheduler of available core
+        coreAvailable[coreId] = false;
+        markCoreBusy(coreId);
+        runSlice(coreId, process);
     }
 }
 
-void Scheduler::worker(int coreId, std::shared_ptr<Process> process) {
-    if (process == nullptr) {
+// Pins an emulated core to one of the allowed host CPUs, then rebuilds its run queue from the pinned
+// thread. The core drains arrivals and requeues onto that queue itself, so it first touches the queue's
+// storage from its own CPU; thieves on other CPUs still reach into it.
+void Scheduler::placeCore(int coreId) {
+    if (!pinCurrentThread(coreId)) {
+        std::cerr << "Warning: could not pin core " << coreId << " to a host CPU.\n";
+    }
+    {
+        std::lock_guard<std::mutex> lock(runQueues[coreId].runMutex);
+        runQueues[coreId].policy = SchedulingPolicy::create(type, timeSlice);
+    }
+}
+
+// Runs one slice of a process on a core, as long as the core's policy allows
+void Scheduler::runSlice(int coreId, std::shared_ptr<Process> process) {
+    if (process == nullptr || process->getName().empty()) {
         return;
     }
-    if (process != nullptr && !process->getName().empty()) {
-        process->setState(Process::RUNNING);
-        process->setCoreID(coreId);
+    process->setState(Process::RUNNING);
+    if (process->assignCore(coreId)) {
+        migrations++;
+    }
 
-        while (!process->isFinished() && process->getState() != Process::WAITING) {
-            process->executeCommand(coreId);
-            incrementTicks(1);
-            
-            std::this_thread::sleep_for(chrono::milliseconds(delaysPerExec));
-        }
-        coreAvailable[coreId] = true;   //set to true now since done
+    int slice = sliceLength(coreId, process);
+    memoryManager.touchPages(process->getPID(), process->getCommandCounter(), slice);
+    long long sliceStart = fineClockNow();
+    int ctr = 0;
+    if (delaysPerExec == 0) {   //no delay to honour between instructions so run the slice as one batch
+        ctr = process->executeBatch(coreId, slice).executed;
+        incrementTicks(coreId, ctr);
+    }
+    while (ctr < slice && !process->isFinished() && !shuttingDown) {
+        int executed = process->executeBatch(coreId, 1).executed;
+        ctr += executed;
+        incrementTicks(coreId, executed);
+        std::this_thread::sleep_for(chrono::milliseconds(delaysPerExec));
+    }
+    process->addRunTicks(fineClockNow() - sliceStart);
+    releaseCore(coreId, process, ctr);
+}
+
+// How long a ready process is kept for the core that last ran it: about one quantum on that core
+long long Scheduler::affinityHold() {
+    return (long long)std::max(timeSlice, 1) * (delaysPerExec + 1);
+}
+
+// Instructions the next slice of the process may run: its policy time slice or everything left
+int Scheduler::sliceLength(int coreId, const std::shared_ptr<Process>& process) {
+    int remaining = process->getLinesOfCode() - process->getCommandCounter();
+    int slice = runQueues[coreId].policy->timeSlice(process);
+    if (slice <= 0 || slice > remaining) {
+        return remaining;
+    }
+    return slice;
+}
+
+// Gives the core back after a slice: an unfinished process is requeued, otherwise its memory is released
+void Scheduler::releaseCore(int coreId, std::shared_ptr<Process> process, int executed) {
+    runQueues[coreId].policy->onSliceEnd(process, executed);
+    memoryManager.setStatus(process->getPID(), Residency::IDLE);
+    markCoreIdle(coreId);
+    coreAvailable[coreId] = true;   //set to true now since done
+
+    if (!process->isFinished()) {
+        process->setState(Process::WAITING);
+        process->setCoreID(-1);
+        enqueueReady(coreId, process);   //stays on this core's run queue
+    }
+    else {
+        process->setFinishTick(fineClockNow());
+        ProcessTable::getInstance()->recordFinished(process->getHot());
         memoryManager.deallocateMemory(process->getPID());
-        cv.notify_all(); 
+        memoryManager.retireProcess(process->getPID());
+        ConsoleManager::getInstance()->retireProcess(process->getName());
+        LogWriter::getInstance()->log({ static_cast<int64_t>(std::time(nullptr)), process->getPID(), static_cast<int16_t>(coreId), LogRecord::FINISH,
+            Opcode::PRINT, static_cast<uint32_t>(process->getCommandCounter()), static_cast<uint32_t>(process->getLinesOfCode()) });
+    }
+    LogWriter::getInstance()->publish();    //the slice's execution records, once per slice
+    if (virtualClock) {
+        wakeScheduler(); // Notify scheduler of available core
+    }
+    else if (!process->isFinished()) {
+        postWork(1);    //an idle peer may steal the requeued process
+    }
+}
+
+// Discrete-event loop of the virtual-clock mode: nothing sleeps, the clock jumps from one event to the next
+void Scheduler::simulate() {
+    useRandomStream(GENERATOR_STREAM);  //generation and replay both run on this thread
+    while (true) {
+        bool pending;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (events.empty()) {   //nothing scheduled so wait for a process or the generator
+                cv.wait(lock, [this] { return dispatchPending; });
+            }
+            pending = dispatchPending;
+            dispatchPending = false;
+        }
+        if (shuttingDown) {
+            return;
+        }
+
+        if (pending) {
+            if (generating && !generatorScheduled && !stop) {
+                pushEvent(currentCycle, SimEvent::GENERATE, -1, 0);
+                generatorScheduled = true;
+            }
+            if (replaying && !replayScheduled && !stop) {
+                pushEvent(std::max<long long>(currentCycle, replayStart + (*trace)[traceNext].arrival), SimEvent::REPLAY, -1, 0);
+                replayScheduled = true;
+            }
+            fillFreeCores();
+            if (affinityRetryAt >= 0 && affinityRetryAt != affinityWakeAt) {
+                pushEvent(affinityRetryAt, SimEvent::AFFINITY_WAKE, -1, 0);
+                affinityWakeAt = affinityRetryAt;
+            }
+        }
+        if (events.empty()) {
+            continue;
+        }
+
+        SimEvent event = events.top();
+        events.pop();
+        advanceClock(event.cycle);
+
+        if (event.type == SimEvent::GENERATE) {
+            if (stop) {
+                generatorScheduled = false;
+                continue;
+            }
+            generateBatch(1);
+            pushEvent(currentCycle + std::max(batchFreq, 1), SimEvent::GENERATE, -1, 0);
+        }
+        else if (event.type == SimEvent::REPLAY) {
+            if (!stop) {
+                replayDue(currentCycle - replayStart);
+            }
+            if (!stop && traceNext < trace->size()) {
+                pushEvent(replayStart + (*trace)[traceNext].arrival, SimEvent::REPLAY, -1, 0);
+            }
+            else {
+                replayScheduled = false;
+                replaying = false;
+            }
+        }
+        else if (event.type == SimEvent::AFFINITY_WAKE) {   //a held process may now migrate
+            wakeScheduler();
+        }
+        else {  //CORE_DONE: run the slice's instructions and give the core back
+            std::shared_ptr<Process> process = simCores[event.coreId];
+            simCores[event.coreId] = nullptr;
+            int executed = process->executeBatch(event.coreId, event.instructions).executed;
+            long long sliceCycles = (long long)event.instructions * (delaysPerExec + 1);
+            process->addRunTicks(sliceCycles);
+            incrementTicks(event.coreId, sliceCycles);
+            releaseCore(event.coreId, process, executed);
+        }
+    }
+}
+
+// Starts a slice on a core in virtual-clock mode; each instruction costs 1 + delay-per-exec cycles
+void Scheduler::startSlice(int coreId, std::shared_ptr<Process> process) {
+    process->setState(Process::RUNNING);
+    if (process->assignCore(coreId)) {
+        migrations++;
+    }
+
+    int slice = sliceLength(coreId, process);
+    memoryManager.touchPages(process->getPID(), process->getCommandCounter(), slice);
+    simCores[coreId] = process;
+    pushEvent(currentCycle + (long long)slice * (delaysPerExec + 1), SimEvent::CORE_DONE, coreId, slice);
+}
+
+void Scheduler::pushEvent(long long cycle, SimEvent::Type type, int coreId, int instructions) {
+    events.push({ cycle, eventSeq++, type, coreId, instructions });
+}
+
+// Moves the virtual clock forward; idle and busy time is charged when cores change state
+void Scheduler::advanceClock(long long cycle) {
+    if (cycle > currentCycle) {
+        currentCycle = cycle;
     }
 }
 
@@ -239,7 +668,9 @@ void Scheduler::reportUtil() {
     std::ofstream outFile("csopesy-log.txt");
     if (outFile.is_open()) {
         screenInfo(outFile);
+        turnaroundInfo(outFile);
         outFile.close();
+        turnaroundInfo(std::cout);
     }
     else {
         std::cerr << "Error: Unable to open log file.\n";
@@ -254,34 +685,28 @@ void Scheduler::screenInfo(std::ostream& shortcut) {
     shortcut << "--------------------------------------------------\n";
     shortcut << "Running processes:\n";
 
-    {
-        for (const auto& process : processes) {
-            if (process->getState() == Process::RUNNING && process->getCoreID() != -1) {
-                shortcut << process->getName() << "\tStarted: " << process->getStartTime()
-                    << "   Core: " << process->getCoreID() << "   " << process->getCommandCounter() << " / "
-                    << process->getLinesOfCode() << std::endl;
-                runCtr++;
-            }
+    ProcessTable* table = ProcessTable::getInstance();
+    table->forEach([&](const ProcessHot& hot) {   //dense scan, no Process objects are touched
+        if (hot.state == Process::RUNNING && hot.coreID != -1) {
+            shortcut << *hot.name << "\tStarted: " << Process::formatStartTime(hot.created)
+                << "   Core: " << hot.coreID << "   " << hot.commandCounter << " / "
+                << hot.linesOfCode << std::endl;
+            runCtr++;
         }
-    }
+    });
 
     if (runCtr == 0) {
         shortcut << "    No running processes.\n";
     }
     shortcut << "\nFinished processes:\n";
 
-    {
-        for (const auto& process : processes) {
-            std::lock_guard<std::mutex> processLock(process->processMutex);
-            if (process->getState() == Process::FINISHED) {
-                shortcut << process->getName() << "\tEnded: " << process->getEndTime()
-                    << "   Finished " << process->getCommandCounter()
-                    << " / " << process->getLinesOfCode() << std::endl
-                    << "\t\tStarted: " << process->getStartTime()
-                    << "   Core: " << process->getCoreID() << std::endl;
-                finCtr++;
-            }
-        }
+    for (const FinishedProcess& done : table->getFinished()) {
+        shortcut << *done.name << "\tEnded: " << Process::formatEndTime(done.ended)
+            << "   Finished " << done.commandCounter
+            << " / " << done.linesOfCode << std::endl
+            << "\t\tStarted: " << Process::formatStartTime(done.created)
+            << "   Core: " << done.coreID << std::endl;
+        finCtr++;
     }
 
     if (finCtr == 0) {
@@ -290,18 +715,83 @@ void Scheduler::screenInfo(std::ostream& shortcut) {
     shortcut << "--------------------------------------------------\n\n";
 }
 
+// A fine clock span for the reports: cycles, or milliseconds to the microsecond in real time
+std::string Scheduler::formatClockSpan(long long span) {
+    if (virtualClock) {
+        return std::to_string(span) + " cycles";
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%lld.%03lld ms", span / 1000, span % 1000);
+    return text;
+}
+
+// Mean turnaround and waiting time of the finished processes, to compare scheduling policies
+void Scheduler::turnaroundInfo(std::ostream& shortcut) {
+    ProcessTable* table = ProcessTable::getInstance();
+    long long finished = table->getFinishedCount();
+    long long turnaround = table->getTurnaroundSum();
+    long long waiting = table->getWaitingSum();
+
+    shortcut << "Scheduler: " << type << "\n";
+    shortcut << "Finished processes: " << finished << "\n";
+    if (finished > 0) {
+        shortcut << "Average turnaround time: " << formatClockSpan(turnaround / finished) << "\n";
+        shortcut << "Average waiting time: " << formatClockSpan(waiting / finished) << "\n";
+    }
+    shortcut << "--------------------------------------------------\n\n";
+}
+
+// Scheduler clock: simulated cycles in virtual-clock mode, otherwise milliseconds since the scheduler was made
+long long Scheduler::clockNow() {
+    if (virtualClock) {
+        return currentCycle;
+    }
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - clockStart).count();
+}
+
+// Random engine of the calling thread, seeded from its role's stream on the first draw
+struct ThreadRandom {
+    const Scheduler* owner = nullptr;
+    int stream = Scheduler::CONSOLE_STREAM;
+    Random engine{ 0 };
+};
+static thread_local ThreadRandom threadRandomState;
+
+// Called first thing by the threads that generate processes. Threads that never call it are console threads.
+void Scheduler::useRandomStream(RandomStream stream) {
+    threadRandomState.stream = stream;
+    threadRandomState.owner = nullptr;
+}
+
+// Engine of the calling thread. Each role draws from its own fixed stream of the scheduler seed, so with
+// a fixed seed the generator (or the simulation thread) draws the same numbers whatever the console drew first.
+Random& Scheduler::threadRandom() {
+    ThreadRandom& state = threadRandomState;
+    if (state.owner != this) {
+        state.engine = Random(seed ^ Random::mix(static_cast<uint64_t>(state.stream) + 1));
+        state.owner = this;
+    }
+    return state.engine;
+}
+
 int Scheduler::generateRandomNumber(int minIns, int maxIns) {
-    random_device random;
-    mt19937 generate(random());
-    uniform_int_distribution<> distr(minIns, maxIns);
-    return distr(generate);
+    return threadRandom().between(minIns, maxIns);
 }
 
 int Scheduler::generateInstructions() {
-    random_device random;
-    mt19937 generate(random());
-    uniform_int_distribution<> distr(minIns, maxIns);
-    return distr(generate);
+    return generateRandomNumber(minIns, maxIns);
+}
+
+uint64_t Scheduler::generateProgramSeed() {
+    return threadRandom().next();
+}
+
+uint64_t Scheduler::getSeed() const {
+    return seed;
+}
+
+std::string Scheduler::getReplacementName() const {
+    return memoryManager.getReplacementName();
 }
 
 int Scheduler::generateMemory() {
@@ -314,11 +804,13 @@ int Scheduler::generateMemory() {
 void Scheduler::printProcessSMI() {
     float cpuUtil = getCpuUtilization();
     memoryManager.printMemoryDetails(cpuUtil);
+    std::cout << "Core migrations: " << migrations << std::endl;
+    std::cout << "Program images: " << Program::internedCount() << " shared" << std::endl << std::endl;
 }
 
 void Scheduler::printVmstat() {
-    long long currentIdle = idleTicks;
-    long long currentActive = activeTicks;
+    long long currentIdle = getIdleTicks();
+    long long currentActive = getActiveTicks();
     std::cout << makeSpaces(memoryManager.getMaxMemory()) << " KB total memory" << std::endl;
     std::cout << makeSpaces(memoryManager.getUsedMemory()) << " KB used memory" << std::endl;
     std::cout << makeSpaces(memoryManager.getAvailableMemory()) << " KB free memory" << std::endl;
@@ -326,28 +818,20 @@ void Scheduler::printVmstat() {
     std::cout << makeSpacesTicks(currentActive) << " active cpu ticks" << std::endl;
     std::cout << makeSpacesTicks(currentIdle + currentActive) << " total cpu ticks" << std::endl;
     std::cout << makeSpaces(memoryManager.getPagedIn()) << " num paged in" << std::endl;
-    std::cout << makeSpaces(memoryManager.getPagedOut()) << " num paged out" << std::endl << std::endl;
+    std::cout << makeSpaces(memoryManager.getPagedOut()) << " num paged out" << std::endl;
+    std::cout << makeSpacesTicks(memoryManager.getPageReferences()) << " page references" << std::endl;
+    std::cout << makeSpacesTicks(memoryManager.getPageFaults()) << " page faults" << std::endl;
+    long long references = memoryManager.getPageReferences();
+    char rate[32];
+    snprintf(rate, sizeof(rate), "%10.2f", references > 0 ? 100.0 * memoryManager.getPageFaults() / references : 0.0);
+    std::cout << rate << " % fault rate (" << memoryManager.getReplacementName() << " replacement)" << std::endl << std::endl;
 }
 
 int Scheduler::countAvailCores() {
     int count = 0;
-    if (type == "rr") {
-        {
-            for (int coreId = 0; coreId < numCores; ++coreId) {
-                if (coreAvailable[coreId]) { // Check if core is marked as available
-                    count++;
-                }
-            }
-        }
-    }
-    else { // fcfs
-        count = numCores;
-        {
-            for (const auto& process : processes) { //more updated version instead of checking coresAvailable
-                if (process->getState() == Process::RUNNING && process->getCoreID() != -1) {
-                    count--;
-                }
-            }
+    for (int coreId = 0; coreId < numCores; ++coreId) {
+        if (coreAvailable[coreId]) { // Check if core is marked as available
+            count++;
         }
     }
     return count;
@@ -389,33 +873,52 @@ std::string Scheduler::makeSpacesTicks(long long input) {
     return newString;
 }
 
-void Scheduler::startTicks() {
-    while (true) {
-        for (int coreId = 0; coreId < numCores; ++coreId) {
-            if (coreAvailable[coreId] == true) {
-                idleTicks++;
-            }
-        }
-        std::this_thread::sleep_for(chrono::milliseconds(10));
+// Clock the idle intervals and the turnaround statistics are measured on: simulated cycles,
+// or microseconds in real time, fine enough to see slices shorter than a millisecond
+long long Scheduler::fineClockNow() {
+    if (virtualClock) {
+        return currentCycle;
     }
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - clockStart).count();
+}
+
+// Fine clock units per idle tick: one cycle, or the time one instruction takes in real time
+long long Scheduler::idleClockPerTick() {
+    return virtualClock ? 1 : std::max(delaysPerExec, 1) * 1000LL;
+}
+
+// A core leaving idle closes its idle interval; nothing is counted while it stays idle
+void Scheduler::markCoreBusy(int coreId) {
+    CoreTicks& ticks = coreTicks[coreId];
+    ticks.idle.fetch_add(fineClockNow() - ticks.idleSince.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void Scheduler::markCoreIdle(int coreId) {
+    coreTicks[coreId].idleSince.store(fineClockNow(), std::memory_order_relaxed);
 }
 
 long long Scheduler::getActiveTicks() {
-    std::lock_guard<std::mutex> lock(cpuMutex);
-    return activeTicks;
+    long long total = 0;
+    for (const auto& ticks : coreTicks) {
+        total += ticks.active.load(std::memory_order_relaxed);
+    }
+    return total;
 }
 
-void Scheduler::incrementTicks(long long ticks) {
-    std::lock_guard<std::mutex> lock(cpuMutex);
-    activeTicks += ticks;
+// Only the owning core writes its counter, so this never contends
+void Scheduler::incrementTicks(int coreId, long long ticks) {
+    coreTicks[coreId].active.fetch_add(ticks, std::memory_order_relaxed);
 }
 
+// Closed idle intervals plus the open interval of every core that is idle right now
 long long Scheduler::getIdleTicks() {
-    std::lock_guard<std::mutex> lock(cpuMutex);
-    return idleTicks;
+    long long now = fineClockNow();
+    long long idle = 0;
+    for (int coreId = 0; coreId < numCores; ++coreId) {
+        idle += coreTicks[coreId].idle.load(std::memory_order_relaxed);
+        if (coreAvailable[coreId]) {
+            idle += now - coreTicks[coreId].idleSince.load(std::memory_order_relaxed);
+        }
+    }
+    return idle / idleClockPerTick();
 }
-
-void Scheduler::incrementIdleTicks(long long ticks) {
-    std::lock_guard<std::mutex> lock(cpuMutex);
-    idleTicks += ticks;
-}
\ No newline at end of file
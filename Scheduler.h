@@ -1,33 +1,89 @@
 #pragma once
 #include "MemoryManager.h"
 #include "Process.h"
+#include "SchedulingPolicy.h"
+#include "Random.h"
+#include "Trace.h"
+#include "SlabPool.h"
 #include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <vector>
 #include <string>
 #include <condition_variable>
 #include <atomic>
+#include <functional>
+#include <chrono>
 
 
+// Where an idle emulated core sleeps; posters only take the mutex when parked is set
+struct CoreSlot {
+    std::mutex slotMutex;
+    std::condition_variable slotCv;
+    std::atomic<bool> parked{ false };
+};
+
+// Per-core ready queue; the core drains arrivals onto it, requeues onto it, and idle cores steal from it
+struct RunQueue {
+    std::mutex runMutex;
+    std::unique_ptr<SchedulingPolicy> policy;   // decides the order of this core's ready processes
+};
+
+// Node of the lock-free stack new arrivals are pushed onto
+struct ArrivalNode {
+    std::shared_ptr<Process> process;
+    ArrivalNode* next;
+};
+
+// Tick counters of one core, padded to a cache line so cores never share one
+struct alignas(64) CoreTicks {
+    std::atomic<long long> active{ 0 };     // instructions, or busy cycles in virtual-clock mode
+    std::atomic<long long> idle{ 0 };       // closed idle intervals, in fine clock units
+    std::atomic<long long> idleSince{ 0 };  // start of the open idle interval while the core is free
+};
+
+// Event of the virtual-clock simulation, ordered by cycle and then by insertion
+struct SimEvent {
+    enum Type { GENERATE, CORE_DONE, AFFINITY_WAKE, REPLAY };
+    long long cycle;
+    long long seq;
+    Type type;
+    int coreId;
+    int instructions;   // length of the slice for CORE_DONE
+
+    bool operator>(const SimEvent& other) const {
+        return cycle != other.cycle ? cycle > other.cycle : seq > other.seq;
+    }
+};
+
 class Scheduler {
 public:
-    Scheduler(int numCores, const std::string& type, int timeSlice, int freq, int min, int max, int delay, int memMax, int memFrame, int minMemProc, int maxMemProc);
+    static const int GENERATOR_PERIOD_MS = 50;     // shortest real-time pause between generated batches
+
+    // Fixed stream of the seed each thread role draws from
+    enum RandomStream { GENERATOR_STREAM, CONSOLE_STREAM, REPLAY_STREAM };
+
+    Scheduler(int numCores, const std::string& type, int timeSlice, int freq, int min, int max, int delay, int memMax, int memFrame, int minMemProc, int maxMemProc, bool virtualClock = false, bool pinCores = false, uint64_t seed = 0, const std::string& pageReplacement = "fifo", int workingSetWindow = 0);
     void addProcess(std::shared_ptr<Process> process);
+    void addProcesses(const std::vector<std::shared_ptr<Process>>& batch);
     void startScheduling();
     void generateProcesses();
-    void startTicksProcesses();
+    long long replayTrace(const std::string& path, std::string& error);
     void stopScheduler();
+    void shutdown();
     void printActiveScreen();
     void reportUtil();
     void screenInfo(std::ostream& shortcut);
-
-    void scheduleFCFS();
-    void scheduleRR();
+    void turnaroundInfo(std::ostream& shortcut);
+    long long clockNow();
 
     int generateRandomNumber(int min, int max);
     int generateInstructions();
     int generateMemory();
+    uint64_t generateProgramSeed();
+    uint64_t getSeed() const;
+    std::string getReplacementName() const;
 
     void printProcessSMI();
     void printVmstat();
@@ -39,43 +95,97 @@ public:
     std::string makeSpacesTicks(long long input);
     
 
-    void startTicks();
     long long getActiveTicks();
-    void incrementTicks(long long ticks);
+    void incrementTicks(int coreId, long long ticks);
     long long getIdleTicks();
-    void incrementIdleTicks(long long ticks);
 
 private:
-    void schedule();
-    void generateProcess();
-    void worker(int coreId, std::shared_ptr<Process> process);
-    void workerRR(int coreId, std::shared_ptr<Process> process);
+    void generateBatch(int count);
+    Random& threadRandom();
+    void useRandomStream(RandomStream stream);
+    void replayDue(long long now);
+    void runSlice(int coreId, std::shared_ptr<Process> process);
+    int sliceLength(int coreId, const std::shared_ptr<Process>& process);
+    long long affinityHold();
+    void coreLoop(int coreId);
+    void placeCore(int coreId);
+    void parkCore(int coreId, long long epoch, long long retryAt);
+    bool admit(const std::shared_ptr<Process>& process);
+    void pushArrivals(const std::vector<std::shared_ptr<Process>>& batch);
+    void drainArrivals(int coreId);
+    void enqueueReady(int coreId, std::shared_ptr<Process> process);
+    std::shared_ptr<Process> takeReady(int coreId, long long& retryAt);
+    std::shared_ptr<Process> steal(int coreId, long long& retryAt);
+    std::shared_ptr<Process> takeWoken();
+    void wakeScheduler();
+    void postWork(int count);
+    void fillFreeCores();
+    void releaseCore(int coreId, std::shared_ptr<Process> process, int executed);
+
+    // virtual-clock mode
+    void simulate();
+    void startSlice(int coreId, std::shared_ptr<Process> process);
+    void pushEvent(long long cycle, SimEvent::Type type, int coreId, int instructions);
+    void advanceClock(long long cycle);
+
+    void markCoreBusy(int coreId);
+    void markCoreIdle(int coreId);
+    long long fineClockNow();
+    std::string formatClockSpan(long long span);
+    long long idleClockPerTick();
     int countAvailCores();
 
     MemoryManager memoryManager;
 
     std::thread schedulerThread;
     std::thread generateProcessThread;
-    std::thread ticksThread;
+    std::thread replayThread;
     std::thread printThread;
-    std::vector<std::shared_ptr<Process>> processes;
-    std::queue<std::shared_ptr<Process>> processQueue;
-    std::vector<std::thread> workers;
+    uint64_t seed;                      // workload seed, from the config or drawn once at startup
+    std::vector<RunQueue> runQueues;
+    std::atomic<ArrivalNode*> arrivals{ nullptr };
+    std::atomic<long long> workEpoch{ 0 };  // bumped by every postWork, parked cores compare against it
+    std::deque<std::shared_ptr<Process>> memoryWoken;  // released from the memory-wait list, oldest first
+    std::mutex wokenMutex;
+    std::atomic<int> wokenCount{ 0 };   // size of memoryWoken, read without the lock
+    long long affinityRetryAt = -1;     // simulation: earliest tick a held process may migrate, -1 if none
+    long long affinityWakeAt = -1;      // AFFINITY_WAKE already queued in virtual-clock mode
+    std::atomic<long long> migrations{ 0 };
+    std::vector<std::thread> workers;       // one persistent thread per emulated core
+    std::vector<CoreSlot> coreSlots;
+    bool pinCores = false;              // pin each core thread to a host CPU and keep its run queue on the local node
     std::mutex queueMutex;
-    std::mutex cpuMutex;
     std::condition_variable cv;
     bool stop = false;
+    std::atomic<bool> shuttingDown{ false };    // set once by shutdown, ends the core threads and the simulation
+    bool dispatchPending = false;       // simulation: set by wakeScheduler, guarded by queueMutex
     bool stopPrinting = false;
     
     std::string type;
-    std::vector<bool> coreAvailable;
+    std::vector<std::atomic<bool>> coreAvailable;   // written by core threads, read by the dispatcher
 
     int numCores;
     int timeSlice = 0;
     int minIns, maxIns, batchFreq, delaysPerExec;
     int maxOverallMem, memPerFrame, minMemPerProc, maxMemPerProc;
 
-    long long activeTicks, idleTicks;
+    std::vector<CoreTicks, AlignedAllocator<CoreTicks>> coreTicks;   // std::allocator ignores alignas(64) before C++17
+
+    bool virtualClock = false;          // run on a simulated cycle counter instead of real sleeps
+    std::priority_queue<SimEvent, std::vector<SimEvent>, std::greater<SimEvent>> events;
+    std::vector<std::shared_ptr<Process>> simCores;    // process running on each core in virtual-clock mode
+    std::atomic<long long> currentCycle{ 0 };
+    std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+    long long eventSeq = 0;
+    std::atomic<bool> generating{ false };
+    bool generatorScheduled = false;
+
+    // trace replay
+    std::unique_ptr<Trace> trace;
+    size_t traceNext = 0;               // first record not created yet
+    long long replayStart = 0;          // clock value the trace's arrival times count from
+    std::atomic<bool> replaying{ false };
+    bool replayScheduled = false;       // REPLAY already queued in virtual-clock mode
 };
 
 
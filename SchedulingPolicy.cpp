@@ -0,0 +1,23 @@
+#include "SchedulingPolicy.h"
+#include "FCFSPolicy.h"
+#include "RRPolicy.h"
+#include "MLFQPolicy.h"
+#include "SJFPolicy.h"
+#include <algorithm>
+
+// Picks the policy named by the "scheduler" key of config.txt, first come first serve by default
+std::unique_ptr<SchedulingPolicy> SchedulingPolicy::create(const std::string& type, int timeSlice) {
+    if (type == "rr") {
+        return std::make_unique<RRPolicy>(timeSlice);
+    }
+    if (type == "sjf") {
+        return std::make_unique<SJFPolicy>(0);
+    }
+    if (type == "srtf") {
+        return std::make_unique<SJFPolicy>(std::max(timeSlice, 1));
+    }
+    if (type == "mlfq") {
+        return std::make_unique<MLFQPolicy>(timeSlice);
+    }
+    return std::make_unique<FCFSPolicy>();
+}
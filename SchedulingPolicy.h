@@ -0,0 +1,24 @@
+#pragma once
+#include "Process.h"
+#include <memory>
+#include <string>
+
+// Ready-queue discipline of one core. The scheduler keeps one instance per core,
+// guarded by that core's run-queue mutex, and asks it what to run next and for how long.
+class SchedulingPolicy {
+public:
+    virtual ~SchedulingPolicy() = default;
+
+    virtual void push(std::shared_ptr<Process> process) = 0;     // arrival or requeue after a slice
+    virtual std::shared_ptr<Process> pop() = 0;                  // next process for the owning core
+    virtual std::shared_ptr<Process> steal() = 0;                // process to give away to an idle peer
+    virtual std::shared_ptr<Process> stealCandidate() const = 0; // what steal() would return, left in place
+    virtual size_t size() const = 0;
+
+    // Instructions the process may run before it is preempted, 0 to run until it finishes
+    virtual int timeSlice(const std::shared_ptr<Process>& process) const = 0;
+    // Feedback after a slice of executed instructions, called before the process is requeued
+    virtual void onSliceEnd(const std::shared_ptr<Process>& /*process*/, int /*executed*/) {}
+
+    static std::unique_ptr<SchedulingPolicy> create(const std::string& type, int timeSlice);
+};
@@ -0,0 +1,201 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Memory aligned beyond what operator new guarantees before C++17, e.g. for alignas(64) types
+inline void* allocateAligned(size_t size, size_t align) {
+    void* memory = nullptr;
+#ifdef _MSC_VER
+    memory = _aligned_malloc(size, align);
+#else
+    if (posix_memalign(&memory, align, size) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+inline void freeAligned(void* memory) {
+#ifdef _MSC_VER
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+// Pool of fixed-size blocks carved out of slabs. Each thread keeps its own free list, so allocating
+// and freeing are a pointer pop/push with no lock; blocks move between a thread and the shared list
+// TRANSFER at a time. Slabs are kept for the life of the program and blocks are recycled, not freed.
+template <size_t Size, size_t Align>
+class SlabPool {
+public:
+    static void* allocate() {
+        Cache& local = cache();
+        if (!local.head) {
+            refill(local);
+        }
+        Block* block = local.head;
+        local.head = block->next;
+        local.count--;
+        return block;
+    }
+
+    static void deallocate(void* pointer) {
+        Cache& local = cache();
+        Block* block = static_cast<Block*>(pointer);
+        block->next = local.head;
+        local.head = block;
+        local.count++;
+        if (local.count >= 2 * TRANSFER) {  //give a batch back so other threads can reuse it
+            Block* chain = local.head;
+            Block* last = chain;
+            for (size_t i = 1; i < TRANSFER; i++) {
+                last = last->next;
+            }
+            local.head = last->next;
+            last->next = nullptr;
+            local.count -= TRANSFER;
+            Shared& pool = shared();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.chains.push_back({ chain, TRANSFER });
+        }
+    }
+
+private:
+    struct Block {
+        Block* next;
+    };
+
+    static const size_t ALIGN = Align > alignof(Block) ? Align : alignof(Block);
+    static const size_t SLOT = Size > sizeof(Block) ? Size : sizeof(Block);    // no std::max, Windows.h may define max
+    static const size_t BLOCK_SIZE = ((SLOT + ALIGN - 1) / ALIGN) * ALIGN;
+    static const size_t TRANSFER = 64;      // blocks per slab and per hand-over between threads
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<std::pair<Block*, size_t>> chains;     // free chains and their lengths
+    };
+
+    struct Cache {
+        Block* head = nullptr;
+        size_t count = 0;
+
+        ~Cache() {  //a finishing thread gives its blocks back
+            if (head) {
+                Shared& pool = shared();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                pool.chains.push_back({ head, count });
+            }
+        }
+    };
+
+    // Never destroyed, so threads that exit late can still give their blocks back
+    static Shared& shared() {
+        static Shared* pool = new Shared();
+        return *pool;
+    }
+
+    static Cache& cache() {
+        thread_local Cache local;
+        return local;
+    }
+
+    static void refill(Cache& local) {
+        Shared& pool = shared();
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (!pool.chains.empty()) {
+                local.head = pool.chains.back().first;
+                local.count = pool.chains.back().second;
+                pool.chains.pop_back();
+                return;
+            }
+        }
+        char* slab = static_cast<char*>(allocateAligned(BLOCK_SIZE * TRANSFER, ALIGN));    //never freed
+        for (size_t i = 0; i < TRANSFER; i++) {
+            Block* block = reinterpret_cast<Block*>(slab + i * BLOCK_SIZE);
+            block->next = i + 1 < TRANSFER ? reinterpret_cast<Block*>(slab + (i + 1) * BLOCK_SIZE) : nullptr;
+        }
+        local.head = reinterpret_cast<Block*>(slab);
+        local.count = TRANSFER;
+    }
+};
+
+// Bound to a reference when a chain is handed over, so it needs a definition before C++17
+template <size_t Size, size_t Align>
+const size_t SlabPool<Size, Align>::TRANSFER;
+
+// Standard allocator over SlabPool, for std::allocate_shared. The shared_ptr control block and
+// the object are one block of the pool for the rebound type.
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(SlabPool<sizeof(T), alignof(T)>::allocate());
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        if (n != 1) {
+            ::operator delete(pointer);
+            return;
+        }
+        SlabPool<sizeof(T), alignof(T)>::deallocate(pointer);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return false;
+}
+
+// Standard allocator that honours alignof(T), for containers of alignas(64) types before C++17
+template <typename T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(allocateAligned(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, size_t) {
+        freeAligned(pointer);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return false;
+}
@@ -0,0 +1,87 @@
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static const char TRACE_MAGIC[4] = { 'C', 'S', 'T', 'R' };
+static const uint32_t TRACE_VERSION = 1;
+
+bool Trace::open(const std::string& path, std::string& error) {
+    std::string binaryPath = path;
+    std::string extension = path.size() > 4 ? path.substr(path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".csv") {
+        binaryPath = path.substr(0, path.size() - 4) + ".trace";
+        if (!convertCsv(path, binaryPath, error)) {
+            return false;
+        }
+    }
+
+    if (!file.open(binaryPath)) {
+        error = "cannot open " + binaryPath;
+        return false;
+    }
+    const TraceHeader* header = reinterpret_cast<const TraceHeader*>(file.data());
+    if (file.size() < sizeof(TraceHeader) || std::memcmp(header->magic, TRACE_MAGIC, 4) != 0 || header->version != TRACE_VERSION) {
+        error = binaryPath + " is not a trace file";
+        file.close();
+        return false;
+    }
+    if (header->count > (file.size() - sizeof(TraceHeader)) / sizeof(TraceRecord)) {
+        error = binaryPath + " is truncated";
+        file.close();
+        return false;
+    }
+    records = reinterpret_cast<const TraceRecord*>(file.data() + sizeof(TraceHeader));
+    count = static_cast<size_t>(header->count);
+    return true;
+}
+
+size_t Trace::size() const {
+    return count;
+}
+
+const TraceRecord& Trace::operator[](size_t index) const {
+    return records[index];
+}
+
+// Lines that do not start with a number (a header row, comments) are skipped
+bool Trace::convertCsv(const std::string& csvPath, const std::string& binaryPath, std::string& error) {
+    std::ifstream in(csvPath);
+    if (!in) {
+        error = "cannot open " + csvPath;
+        return false;
+    }
+
+    std::vector<TraceRecord> rows;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream iss(line);
+        unsigned long long arrival;
+        unsigned long instructions, memory = 0;
+        if (!(iss >> arrival >> instructions)) {
+            continue;
+        }
+        iss >> memory;
+        rows.push_back({ arrival, static_cast<uint32_t>(instructions), static_cast<uint32_t>(memory) });
+    }
+    std::stable_sort(rows.begin(), rows.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.arrival < b.arrival;
+    });
+
+    std::ofstream out(binaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "cannot write " + binaryPath;
+        return false;
+    }
+    TraceHeader header;
+    std::memcpy(header.magic, TRACE_MAGIC, 4);
+    header.version = TRACE_VERSION;
+    header.count = rows.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(TraceRecord));
+    return static_cast<bool>(out);
+}
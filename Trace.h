@@ -0,0 +1,34 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+
+// Binary trace layout: a TraceHeader followed by count TraceRecords, sorted by arrival
+struct TraceHeader {
+    char magic[4];          // "CSTR"
+    uint32_t version;       // 1
+    uint64_t count;
+};
+
+struct TraceRecord {
+    uint64_t arrival;       // clock units after the replay starts: ms, or cycles in virtual-clock mode
+    uint32_t instructions;
+    uint32_t memory;        // 0 draws a size from the config range
+};
+
+// Arrival trace mapped straight from disk. Records are read in place, nothing is copied on load.
+// A CSV trace (arrival,instructions,memory per line) is first converted to a binary file next to it.
+class Trace {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    size_t size() const;
+    const TraceRecord& operator[](size_t index) const;
+
+    static bool convertCsv(const std::string& csvPath, const std::string& binaryPath, std::string& error);
+
+private:
+    MappedFile file;
+    const TraceRecord* records = nullptr;
+    size_t count = 0;
+};
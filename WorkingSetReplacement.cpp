@@ -0,0 +1,39 @@
+#include "WorkingSetReplacement.h"
+
+WorkingSetReplacement::WorkingSetReplacement(int frames, int window)
+    : recency(frames), lastUse(frames, 0), window(window) {}
+
+void WorkingSetReplacement::onLoad(int frame) {
+    lastUse[frame] = ++now;
+    recency.pushBack(frame);
+}
+
+void WorkingSetReplacement::onTouch(int frame) {
+    lastUse[frame] = ++now;
+    recency.remove(frame);
+    recency.pushBack(frame);
+}
+
+void WorkingSetReplacement::onFree(int frame) {
+    recency.remove(frame);
+}
+
+int WorkingSetReplacement::victim() {
+    int frame = recency.front();
+    recency.remove(frame);
+    return frame;
+}
+
+// The oldest reference is at the front, so only the front has to be checked
+int WorkingSetReplacement::expired() {
+    int frame = recency.front();
+    if (frame < 0 || now - lastUse[frame] < window) {
+        return -1;
+    }
+    recency.remove(frame);
+    return frame;
+}
+
+std::string WorkingSetReplacement::getName() const {
+    return "ws";
+}
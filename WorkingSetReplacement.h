@@ -0,0 +1,22 @@
+#pragma once
+#include "ReplacementPolicy.h"
+
+// Working set: a page not referenced within the last window references leaves memory on its own,
+// so resident sets shrink to what processes use. When memory is still full, the least recently
+// referenced page is replaced.
+class WorkingSetReplacement : public ReplacementPolicy {
+public:
+    WorkingSetReplacement(int frames, int window);
+    void onLoad(int frame) override;
+    void onTouch(int frame) override;
+    void onFree(int frame) override;
+    int victim() override;
+    int expired() override;
+    std::string getName() const override;
+
+private:
+    FrameList recency;                  // least recently referenced first
+    std::vector<long long> lastUse;     // reference count at the frame's last reference
+    long long now = 0;                  // references so far, the policy's virtual time
+    int window;
+};
@@ -0,0 +1,151 @@
+// Standalone benchmark, not part of the emulator build.
+// Compares dispatches per second of the old thread-per-dispatch scheme, persistent core threads
+// fed by a dispatcher through handoff slots (the first step away from it), and the current design
+// where each core thread takes processes from its own run queue and requeues them itself.
+// Arrivals, stealing and parking are left out: every queue stays busy for the whole run.
+//
+// usage: DispatchBench [cores] [dispatches per core] [instructions per dispatch]
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <deque>
+
+using namespace std;
+
+static atomic<long long> executed(0);
+
+// Stand-in for one quantum of instructions
+static void runQuantum(int instructions) {
+    for (int i = 0; i < instructions; i++) {
+        executed.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+// Old behaviour: join the previous thread of the core and spawn a new one per dispatch
+double benchSpawnPerDispatch(int cores, int dispatches, int instructions) {
+    vector<thread> workers(cores);
+    auto start = chrono::steady_clock::now();
+    for (int d = 0; d < dispatches; d++) {
+        for (int coreId = 0; coreId < cores; coreId++) {
+            if (workers[coreId].joinable()) {
+                workers[coreId].join();
+            }
+            workers[coreId] = thread(runQuantum, instructions);
+        }
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return double(cores) * dispatches / elapsed.count();
+}
+
+struct Slot {
+    mutex slotMutex;
+    condition_variable slotCv;
+    int work = 0;       // instructions handed to the core, 0 while empty
+    bool busy = false;
+};
+
+// First step: long-lived core threads fed by the dispatcher through a handoff slot
+double benchHandoffSlot(int cores, int dispatches, int instructions) {
+    vector<Slot> slots(cores);
+    vector<thread> workers;
+    for (int coreId = 0; coreId < cores; coreId++) {
+        workers.emplace_back([&slots, coreId, dispatches]() {
+            Slot& slot = slots[coreId];
+            for (int d = 0; d < dispatches; d++) {
+                int work;
+                {
+                    unique_lock<mutex> lock(slot.slotMutex);
+                    slot.slotCv.wait(lock, [&slot] { return slot.work != 0; });
+                    work = slot.work;
+                    slot.work = 0;
+                }
+                runQuantum(work);
+                {
+                    lock_guard<mutex> lock(slot.slotMutex);
+                    slot.busy = false;
+                }
+                slot.slotCv.notify_all();
+            }
+        });
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int d = 0; d < dispatches; d++) {
+        for (int coreId = 0; coreId < cores; coreId++) {
+            Slot& slot = slots[coreId];
+            unique_lock<mutex> lock(slot.slotMutex);
+            slot.slotCv.wait(lock, [&slot] { return !slot.busy; });
+            slot.busy = true;
+            slot.work = instructions;
+            lock.unlock();
+            slot.slotCv.notify_all();
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return double(cores) * dispatches / elapsed.count();
+}
+
+struct RunQueue {
+    mutex runMutex;
+    deque<int> ready;   // instructions per quantum of each queued process
+};
+
+// Current behaviour: a core pops from its own run queue and pushes the process back after its
+// quantum, as Scheduler::takeReady and enqueueReady do, so no dispatcher sits between the cores
+double benchOwnRunQueue(int cores, int dispatches, int instructions) {
+    const int PROCESSES_PER_CORE = 4;
+    vector<RunQueue> queues(cores);
+    for (auto& queue : queues) {
+        queue.ready.assign(PROCESSES_PER_CORE, instructions);
+    }
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int coreId = 0; coreId < cores; coreId++) {
+        workers.emplace_back([&queues, coreId, dispatches]() {
+            RunQueue& queue = queues[coreId];
+            for (int d = 0; d < dispatches; d++) {
+                int work;
+                {
+                    lock_guard<mutex> lock(queue.runMutex);
+                    work = queue.ready.front();
+                    queue.ready.pop_front();
+                }
+                runQuantum(work);
+                lock_guard<mutex> lock(queue.runMutex);
+                queue.ready.push_back(work);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return double(cores) * dispatches / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    int cores = argc > 1 ? stoi(argv[1]) : 4;
+    int dispatches = argc > 2 ? stoi(argv[2]) : 20000;
+    int instructions = argc > 3 ? stoi(argv[3]) : 5;
+
+    cout << "cores: " << cores << ", dispatches per core: " << dispatches
+        << ", instructions per dispatch: " << instructions << endl;
+    cout << "thread per dispatch: " << (long long)benchSpawnPerDispatch(cores, dispatches, instructions)
+        << " dispatches/s" << endl;
+    cout << "handoff slot:        " << (long long)benchHandoffSlot(cores, dispatches, instructions)
+        << " dispatches/s" << endl;
+    cout << "own run queue:       " << (long long)benchOwnRunQueue(cores, dispatches, instructions)
+        << " dispatches/s" << endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Standalone benchmark, not part of the emulator build; it links against the emulator sources.
+// Creates and retires a million processes, each a Process plus its BaseScreen as ConsoleManager
+// makes them, with std::make_shared and with std::allocate_shared over the SlabPool.
+// Every thread retires the batches created by the previous thread, as the core threads
+// retire the processes the generator creates: the process is recorded as finished and dropped.
+//
+// usage: ProcessPoolBench [processes] [threads] [batch size]
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <ctime>
+#include "../SlabPool.h"
+#include "../Process.h"
+#include "../BaseScreen.h"
+#include "../ProcessTable.h"
+
+using namespace std;
+
+struct Created {
+    shared_ptr<Process> process;
+    shared_ptr<BaseScreen> screen;
+};
+
+struct Mailbox {
+    mutex boxMutex;
+    vector<vector<Created>> batches;
+};
+
+template <bool Pooled>
+Created create(int pid, chrono::system_clock::time_point created, time_t screenTime) {
+    string name = "P" + to_string(pid);
+    int lines = 100 + pid % 900;
+    if (Pooled) {
+        auto process = allocate_shared<Process>(PoolAllocator<Process>(), pid, name, lines, created, 4096, uint64_t(pid));
+        auto screen = allocate_shared<BaseScreen>(PoolAllocator<BaseScreen>(), name, process, screenTime);
+        return { process, screen };
+    }
+    auto process = make_shared<Process>(pid, name, lines, created, 4096, uint64_t(pid));
+    auto screen = make_shared<BaseScreen>(name, process, screenTime);
+    return { process, screen };
+}
+
+// What Scheduler::releaseCore does with a finished process before dropping it
+static void retire(vector<Created>& batch) {
+    for (Created& done : batch) {
+        done.process->setState(Process::FINISHED);
+        ProcessTable::getInstance()->recordFinished(done.process->getHot());
+    }
+    batch.clear();
+}
+
+// Processes created and retired per second
+template <bool Pooled>
+double bench(int processes, int threads, int batchSize) {
+    vector<Mailbox> mailboxes(threads);
+    int perThread = processes / threads;
+    vector<thread> workers;
+
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&mailboxes, t, threads, perThread, batchSize]() {
+            Mailbox& next = mailboxes[(t + 1) % threads];
+            Mailbox& own = mailboxes[t];
+            for (int done = 0; done < perThread; done += batchSize) {
+                auto created = chrono::system_clock::now();
+                time_t screenTime = chrono::system_clock::to_time_t(created);
+                vector<Created> batch;
+                batch.reserve(batchSize);
+                for (int i = 0; i < batchSize; i++) {
+                    batch.push_back(create<Pooled>(t * perThread + done + i, created, screenTime));
+                }
+                {
+                    lock_guard<mutex> lock(next.boxMutex);
+                    next.batches.push_back(move(batch));
+                }
+                vector<vector<Created>> retired;
+                {
+                    lock_guard<mutex> lock(own.boxMutex);
+                    retired.swap(own.batches);
+                }
+                for (auto& batch : retired) {
+                    retire(batch);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& mailbox : mailboxes) {
+        for (auto& batch : mailbox.batches) {
+            retire(batch);
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return double(perThread) * threads / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    int processes = argc > 1 ? stoi(argv[1]) : 1000000;
+    int threads = argc > 2 ? stoi(argv[2]) : 4;
+    int batchSize = argc > 3 ? stoi(argv[3]) : 256;
+
+    cout << "processes: " << processes << ", threads: " << threads << ", batch size: " << batchSize << endl;
+    cout << "make_shared: " << (long long)bench<false>(processes, threads, batchSize) << " processes/s" << endl;
+    cout << "slab pool:   " << (long long)bench<true>(processes, threads, batchSize) << " processes/s" << endl;
+    return 0;
+}
@@ -1,7 +1,9 @@
 #include "ConsoleManager.h"
 #include "MainConsole.h"
+#include "LogWriter.h"
 
 int main() {
+    LogWriter::initialize();
     ConsoleManager::initialize();
     ConsoleManager* consoleManager = ConsoleManager::getInstance();
 
@@ -14,5 +16,6 @@ int main() {
     }
 
     ConsoleManager::destroy();
+    LogWriter::destroy();
     return 0;
 }
\ No newline at end of file